@@ -24,6 +24,47 @@
 
 using namespace SDP3X;
 
+/*  CRC-8 Lookup Table
+
+    Settings:
+    INIT           - 0xFF
+    POLY           - 0x31
+    Reflect Input  - No
+    Reflect Output - No
+    Final XOR      - 0x00
+
+    Source: http://www.sunshine2k.de/coding/javascript/crc/crc_js.html
+*/
+#if defined(SDP3X_CRC_NIBBLE)
+/* CRC-8 of each nibble, the first 16 entries of the full table */
+const uint8_t SDP3X::CRC_NIBBLE[16] = { 0x00, 0x31, 0x62, 0x53, 0xC4, 0xF5, 0xA6, 0x97,
+                                        0xB9, 0x88, 0xDB, 0xEA, 0x7D, 0x4C, 0x1F, 0x2E };
+#elif !defined(SDP3X_CRC_BITWISE)
+#if defined(SDP3X_CRC_PROGMEM)
+const uint8_t SDP3X::CRC_LUT[256] PROGMEM =
+#else
+const uint8_t SDP3X::CRC_LUT[256] =
+#endif
+    { 0x00, 0x31, 0x62, 0x53, 0xC4, 0xF5, 0xA6, 0x97, 0xB9, 0x88, 0xDB, 0xEA, 0x7D, 0x4C, 0x1F,
+      0x2E, 0x43, 0x72, 0x21, 0x10, 0x87, 0xB6, 0xE5, 0xD4, 0xFA, 0xCB, 0x98, 0xA9, 0x3E, 0x0F,
+      0x5C, 0x6D, 0x86, 0xB7, 0xE4, 0xD5, 0x42, 0x73, 0x20, 0x11, 0x3F, 0x0E, 0x5D, 0x6C, 0xFB,
+      0xCA, 0x99, 0xA8, 0xC5, 0xF4, 0xA7, 0x96, 0x01, 0x30, 0x63, 0x52, 0x7C, 0x4D, 0x1E, 0x2F,
+      0xB8, 0x89, 0xDA, 0xEB, 0x3D, 0x0C, 0x5F, 0x6E, 0xF9, 0xC8, 0x9B, 0xAA, 0x84, 0xB5, 0xE6,
+      0xD7, 0x40, 0x71, 0x22, 0x13, 0x7E, 0x4F, 0x1C, 0x2D, 0xBA, 0x8B, 0xD8, 0xE9, 0xC7, 0xF6,
+      0xA5, 0x94, 0x03, 0x32, 0x61, 0x50, 0xBB, 0x8A, 0xD9, 0xE8, 0x7F, 0x4E, 0x1D, 0x2C, 0x02,
+      0x33, 0x60, 0x51, 0xC6, 0xF7, 0xA4, 0x95, 0xF8, 0xC9, 0x9A, 0xAB, 0x3C, 0x0D, 0x5E, 0x6F,
+      0x41, 0x70, 0x23, 0x12, 0x85, 0xB4, 0xE7, 0xD6, 0x7A, 0x4B, 0x18, 0x29, 0xBE, 0x8F, 0xDC,
+      0xED, 0xC3, 0xF2, 0xA1, 0x90, 0x07, 0x36, 0x65, 0x54, 0x39, 0x08, 0x5B, 0x6A, 0xFD, 0xCC,
+      0x9F, 0xAE, 0x80, 0xB1, 0xE2, 0xD3, 0x44, 0x75, 0x26, 0x17, 0xFC, 0xCD, 0x9E, 0xAF, 0x38,
+      0x09, 0x5A, 0x6B, 0x45, 0x74, 0x27, 0x16, 0x81, 0xB0, 0xE3, 0xD2, 0xBF, 0x8E, 0xDD, 0xEC,
+      0x7B, 0x4A, 0x19, 0x28, 0x06, 0x37, 0x64, 0x55, 0xC2, 0xF3, 0xA0, 0x91, 0x47, 0x76, 0x25,
+      0x14, 0x83, 0xB2, 0xE1, 0xD0, 0xFE, 0xCF, 0x9C, 0xAD, 0x3A, 0x0B, 0x58, 0x69, 0x04, 0x35,
+      0x66, 0x57, 0xC0, 0xF1, 0xA2, 0x93, 0xBD, 0x8C, 0xDF, 0xEE, 0x79, 0x48, 0x1B, 0x2A, 0xC1,
+      0xF0, 0xA3, 0x92, 0x05, 0x34, 0x67, 0x56, 0x78, 0x49, 0x1A, 0x2B, 0xBC, 0x8D, 0xDE, 0xEF,
+      0x82, 0xB3, 0xE0, 0xD1, 0x46, 0x77, 0x24, 0x15, 0x3B, 0x0A, 0x59, 0x68, 0xFF, 0xCE, 0x9D,
+      0xAC };
+#endif
+
 /*  Send a write command
 
     @param cmd - the two byte command to send
@@ -32,56 +73,37 @@ using namespace SDP3X;
 bool SDP3x::writeCommand(const uint8_t cmd[2]) {
     size_t written;
     uint8_t status;
-    Wire.beginTransmission(this->addr);
-    written = Wire.write(cmd, 2);
-    status  = Wire.endTransmission();
+#ifdef SDP3X_STATS
+    unsigned long start = micros();
+#endif
+    this->wire->beginTransmission(this->addr);
+    written = this->wire->write(cmd, 2);
+    status  = this->wire->endTransmission();
+#ifdef SDP3X_STATS
+    recordWrite(start, (status == 0) && (written == 2));
+#endif
     return (status == 0) && (written == 2);
 }
 
 /*  Read data back from the device
 
-    @param words - the number of words to read
+    @param out         - an array of "words" destinations, NULL entries are checked but not stored
+    @param words       - the number of words to read
+    @param verifyFirst - check the CRC of the first word, otherwise only the others are checked
     @returns true iff all words read and CRC passed
 */
-bool SDP3x::readData(uint8_t words) {
+bool SDP3x::readData(int16_t *const out[], uint8_t words, bool verifyFirst) {
     size_t read;
-    uint8_t crc = 0xFF;
-    uint8_t *next;
-    bool success = true;
-    // Clear buffer
-    for (next = &this->buffer[12]; next > this->buffer; next--) {
-        *next = 0;
-    }
+    bool success;
+#ifdef SDP3X_STATS
+    unsigned long start = micros();
+#endif
     // Each word is two bytes plus a CRC byte, ergo 3 bytes per word
-    read = Wire.requestFrom(this->addr, (uint8_t)(words * 3));
-
-    /*  We should have read the requested number of bytes.
-        If not, we need to clear the bytes read anyways.
-    */
-    if (read != 3 * words) {
-        success = false;
-    }
-    /*  Calculate CRC while reading bytes
-
-        Adapted from:
-        http://www.sunshine2k.de/articles/coding/crc/understanding_crc.html
-    */
-    next = this->buffer;
-    for (; read > 0; read--) {
-        // Read next available byte
-        *next = Wire.read();
-        // Every third byte
-        if ((read % 3) == 1) {
-            // Check CRC byte
-            success = success && (crc == *next);
-            crc     = 0xFF;
-        } else {
-            // Update CRC
-            crc = CRC_LUT[crc ^ *next];
-            // Go to next byte
-            next++;
-        }
-    }
+    read    = this->wire->requestFrom(this->addr, (uint8_t)(words * 3));
+    success = checkData(*this->wire, out, words, read, verifyFirst);
+#ifdef SDP3X_STATS
+    recordRead(start, words, read, success);
+#endif
     return success;
 }
 
@@ -89,11 +111,27 @@ bool SDP3x::readData(uint8_t words) {
 
     @param addr - the Address value for I2C
     @param comp - the Temperature Compensation Mode (Mass Flow or Differential Pressure)
+    @param wire - the I2C bus the sensor is on (ie. Wire1), SDP3xT supports other drivers
     @returns a new SDP3X as configured
 */
-SDP3x::SDP3x(const uint8_t addr, TempCompensation comp) {
-    this->addr = addr;
-    this->comp = comp;
+SDP3x::SDP3x(const uint8_t addr, TempCompensation comp, TwoWire &wire) {
+    this->wire         = &wire;
+    this->addr         = addr;
+    this->comp         = comp;
+    this->pending      = 0;
+    this->callback     = NULL;
+#ifdef SDP3X_ASYNC_I2C
+    this->requested    = false;
+    this->requestTime  = 0;
+#endif
+    this->sequence     = 0;
+    this->missed       = false;
+    this->pressureCRC  = true;
+    this->identified   = false;
+    this->serialCached = false;
+#ifdef SDP3X_STATS
+    resetStats();
+#endif
 }
 
 /*  Finish Initializing the sensor object
@@ -102,22 +140,36 @@ SDP3x::SDP3x(const uint8_t addr, TempCompensation comp) {
 */
 bool SDP3x::begin() {
     uint32_t modelNumber;
+    // Forget any cached information, in case a different sensor is now at this address
+    this->identified   = false;
+    this->serialCached = false;
     if (!readProductID(&modelNumber, NULL)) {
         return false;
     }
     switch (modelNumber) {
     case SDP31_PID:
-        this->number = SDP31;
-        return true;
+        return begin(SDP31);
     case SDP32_PID:
-        this->number = SDP32;
-        return true;
+        return begin(SDP32);
     default:
         /* do nothing for now */
         return false;
     }
 }
 
+/*  Finish Initializing the sensor object for a known model
+
+    No I2C communication is made, which makes this suitable for waking from sleep.
+    @param model - the sensor model, as previously found by "begin()"
+    @returns true, iff everything went correctly
+*/
+bool SDP3x::begin(Model model) {
+    this->number       = model;
+    this->identified   = true;
+    this->serialCached = false;
+    return true;
+}
+
 /*  Begin taking continuous readings
 
     @param averaging - average samples until read occurs, otherwise read last value only
@@ -187,55 +239,240 @@ bool SDP3x::triggerMeasurement(bool stretching) {
     @returns true, iff everything went correctly
 */
 bool SDP3x::readMeasurement(int16_t *pressure, int16_t *temp, int16_t *scale) {
-    uint8_t words = 1;
+    int16_t *const out[3] = { pressure, temp, scale };
+    uint8_t words         = 1;
     if (scale != NULL) {
         words = 3;
     } else if (temp != NULL) {
         words = 2;
     }
-    if (!readData(words)) {
-        return false;
-    }
     /*  Data Format:
-        | Byte  |  0  |  1  |  2  |  3  |  4  |  5  |
-        | Value | pressure  | temp      | scale     |
+        | Word  |    0     |  1   |   2   |
+        | Value | pressure | temp | scale |
     */
-    switch (words) {
-    case 3:
-        if (scale != NULL) {
-            *scale <<= 8;
-            *scale |= (int16_t)this->buffer[4];
-            *scale <<= 8;
-            *scale |= (int16_t)this->buffer[5];
+    return readData(out, words, this->pressureCRC);
+}
+
+/*  Collect a block of readings at a fixed interval.
+
+    This is meant for continuous mode. Each read is scheduled from the start of the block rather
+    than from the end of the previous read, so that jitter does not accumulate. Collection stops at
+    the first failed read, which is left untouched.
+
+    "temp" should be left NULL if not used. This will reduce read times.
+    @param pressure   - an array of at least "n" raw pressure values
+    @param temp       - if not null, an array of at least "n" raw temperature values
+    @param n          - the number of readings to collect
+    @param intervalUs - the time between readings in microseconds
+    @returns the number of readings collected, "n" iff everything went correctly
+*/
+size_t SDP3x::readMeasurements(int16_t *pressure, int16_t *temp, size_t n, uint16_t intervalUs) {
+    // Decide the read size once for the whole block
+    int16_t *out[2]    = { pressure, temp };
+    uint8_t words      = (temp != NULL) ? 2 : 1;
+    unsigned long next = micros();
+    size_t i;
+    for (i = 0; i < n; i++) {
+        while ((long)(micros() - next) < 0) {
+            // wait for the next slot
         }
-    case 2:
-        if (temp != NULL) {
-            *temp <<= 8;
-            *temp |= (int16_t)this->buffer[2];
-            *temp <<= 8;
-            *temp |= (int16_t)this->buffer[3];
+        next += intervalUs;
+        if (!readData(out, words, this->pressureCRC)) {
+            break;
+        }
+        out[0]++;
+        if (words == 2) {
+            out[1]++;
         }
-    case 1:
-        if (pressure != NULL) {
-            *pressure <<= 8;
-            *pressure |= (int16_t)this->buffer[0];
-            *pressure <<= 8;
-            *pressure |= (int16_t)this->buffer[1];
+    }
+    return i;
+}
+
+/*  Get a pending reading into a sample, with its time and sequence number.
+
+    The sample is written in place, and is only valid on success.
+    @param sample   - the sample to fill
+    @param withTemp - also read the temperature, otherwise only the pressure is read
+    @returns true, iff everything went correctly
+*/
+bool SDP3x::readSample(SDP3xSample *sample, bool withTemp) {
+    int16_t *const out[2] = { &sample->pressure, &sample->temp };
+    sample->time          = micros();
+    sample->sequence      = this->sequence++;
+    if (!readData(out, withTemp ? 2 : 1, this->pressureCRC)) {
+        this->missed = true;
+        return false;
+    }
+    sample->flags = (withTemp ? SampleHasTemp : 0) | (this->missed ? SampleMissed : 0);
+    this->missed  = false;
+    return true;
+}
+
+/*  Collect a block of samples at a fixed interval.
+
+    Scheduled as for "readMeasurements", and collection stops at the first failed read.
+    @param samples    - an array of at least "n" samples
+    @param n          - the number of samples to collect
+    @param intervalUs - the time between readings in microseconds
+    @param withTemp   - also read the temperature, otherwise only the pressure is read
+    @returns the number of samples collected, "n" iff everything went correctly
+*/
+size_t SDP3x::readSamples(SDP3xSample *samples, size_t n, uint16_t intervalUs, bool withTemp) {
+    unsigned long next = micros();
+    size_t i;
+    for (i = 0; i < n; i++) {
+        while ((long)(micros() - next) < 0) {
+            // wait for the next slot
+        }
+        next += intervalUs;
+        if (!readSample(&samples[i], withTemp)) {
+            break;
+        }
+    }
+    return i;
+}
+
+/*  Start a deferred reading, retried by "poll" while the sensor NACKs.
+
+    Nothing is sent until "poll" is called. While the sensor NACKs its address (ie. a triggered
+    measurement without clock stretching is not ready yet), the read stays pending. Unless
+    SDP3X_ASYNC_I2C is defined, every "poll" blocks in Wire.requestFrom, briefly for a NACK and for
+    the whole transfer once data is returned.
+
+    Both "temp" and "scale" should be left NULL if not used. This will reduce read times. Nothing
+    is stored unless every CRC passes, so a failed read leaves all outputs as-is.
+    @param pressure - a pointer to store the raw pressure value
+    @param temp     - a pointer to store the raw temperature value
+    @param scale    - a pointer to store the pressure scaling factor
+    @param callback - if not null, called once the read completes
+    @returns true, iff no other read was already pending
+*/
+bool SDP3x::beginRead(int16_t *pressure, int16_t *temp, int16_t *scale, ReadCallback callback) {
+    if (this->pending != 0) {
+        return false;
+    }
+    this->pending = 1;
+    if (scale != NULL) {
+        this->pending = 3;
+    } else if (temp != NULL) {
+        this->pending = 2;
+    }
+    this->pendingOut[0] = pressure;
+    this->pendingOut[1] = temp;
+    this->pendingOut[2] = scale;
+    this->callback      = callback;
+    return true;
+}
+
+/*  Attempt a pending deferred reading.
+
+    Blocks for one Wire.requestFrom. If the sensor NACKs, the read stays pending.
+
+    When SDP3X_ASYNC_I2C is defined for the whole build, the bus must have the non-blocking
+    "sendRequest" and "done" of i2c_t3 (ie. Teensy 3.x and LC). Then "poll" never waits on the bus:
+    it starts the transfer and returns, and later calls return at once until the bus hardware has
+    finished it. Nothing else may use the bus meanwhile.
+    @returns true, iff a pending read completed during this call (successfully or not)
+*/
+bool SDP3x::poll() {
+    size_t read;
+    uint8_t words = this->pending;
+    bool success;
+    if (words == 0) {
+        return false;
+    }
+#ifdef SDP3X_ASYNC_I2C
+    if (!this->requested) {
+        // The bus hardware clocks the bytes in while the caller gets on with other work
+        this->requestTime = micros();
+        this->requested   = true;
+        this->wire->sendRequest(this->addr, (size_t)(words * 3));
+        return false;
+    }
+    if (!this->wire->done()) {
+        return false;
+    }
+    this->requested = false;
+    read            = this->wire->available();
+#ifdef SDP3X_STATS
+    unsigned long start = this->requestTime;
+#endif
+#else
+#ifdef SDP3X_STATS
+    unsigned long start = micros();
+#endif
+    read = this->wire->requestFrom(this->addr, (uint8_t)(words * 3));
+#endif
+    // A NACK means no new data yet, so try again on the next poll
+    if (read == 0) {
+#ifdef SDP3X_STATS
+        recordRead(start, words, read, false);
+#endif
+        return false;
+    }
+    success       = checkData(*this->wire, this->pendingOut, words, read, this->pressureCRC);
+    this->pending = 0;
+#ifdef SDP3X_STATS
+    recordRead(start, words, read, success);
+#endif
+    if (this->callback != NULL) {
+        this->callback(this, success);
+    }
+    return true;
+}
+
+/*  Abandon a pending deferred reading, without calling its callback
+
+    A transfer already running in the background is waited for, so the bus is free after.
+    @returns true, iff a read was pending
+*/
+bool SDP3x::cancelRead() {
+    if (this->pending == 0) {
+        return false;
+    }
+#ifdef SDP3X_ASYNC_I2C
+    if (this->requested) {
+        while (!this->wire->done()) {
+            // the transfer cannot be stopped part way
         }
+        this->requested = false;
     }
+#endif
+    this->pending = 0;
     return true;
 }
 
+/*  Check for a pending deferred reading
+
+    @returns true, iff a read was started and has not yet completed
+*/
+bool SDP3x::isBusy() {
+    return this->pending != 0;
+}
+
 /*  Read back the sensor's internal information
 
     If a serial number is not needed, "serial" should be set to NULL. This will reduce read
-   times.
+   times. Once "begin" has succeeded, the product ID and serial number are only read from the
+   sensor the first time.
     @param pid     - a pointer to store the 32-bit product ID
     @param serial  - if not null, a pointer to store the 64-bit manufacturer serial number
     @returns true, iff everything went correctly
 */
 bool SDP3x::readProductID(uint32_t *pid, uint64_t *serial) {
-    uint8_t words = 2;
+    int16_t info[6];
+    int16_t *const out[6] = { &info[0], &info[1], &info[2], &info[3], &info[4], &info[5] };
+    uint8_t words         = 2;
+    // Answer from the cache when everything asked for is already known
+    if (this->identified && ((serial == NULL) || this->serialCached)) {
+        if (pid != NULL) {
+            *pid = (this->number == SDP31) ? SDP31_PID : SDP32_PID;
+        }
+        if (serial != NULL) {
+            *serial = this->serialNumber;
+        }
+        return true;
+    }
     if (serial != NULL) {
         words = 6;
     }
@@ -248,34 +485,47 @@ bool SDP3x::readProductID(uint32_t *pid, uint64_t *serial) {
         return false;
     }
     // Read back required data
-    if (!readData(words)) {
+    if (!readData(out, words, true)) {
         return false;
     }
     /*  Data Format:
-        | Byte  | 0 | 1 | 2 | 3 | 4 | 5 | 6 | 7 | 8 | 9 | 10 | 11 |
-        | Value | pid           | serial                          |
+        | Word  | 0 | 1 | 2 | 3 | 4 | 5 |
+        | Value | pid   | serial        |
     */
     switch (words) {
     case 6:
         // "Parse" serial number
         if (serial != NULL) {
-            for (words = 0; words < 8; words++) {
-                *serial <<= 8;
-                *serial |= (uint64_t)this->buffer[words + 4];
+            *serial = 0;
+            for (words = 2; words < 6; words++) {
+                *serial <<= 16;
+                *serial |= (uint16_t)info[words];
+            }
+            // Only worth keeping once the sensor is known to be the one identified
+            if (this->identified) {
+                this->serialNumber = *serial;
+                this->serialCached = true;
             }
         }
+        // fall through
     case 2:
         // "Parse" product identifer
         if (pid != NULL) {
-            for (words = 0; words < 4; words++) {
-                *pid <<= 8;
-                *pid |= (uint32_t)this->buffer[words];
-            }
+            *pid = ((uint32_t)(uint16_t)info[0] << 16) | (uint16_t)info[1];
         }
     }
     return true;
 }
 
+/*  Check that a device acknowledges this address, without sending it a command
+
+    @returns true, iff the address was acknowledged
+*/
+bool SDP3x::probe() {
+    this->wire->beginTransmission(this->addr);
+    return this->wire->endTransmission() == 0;
+}
+
 /*  Reset the device to default settings
 
     WARNING: This will reset all other I2C devices that support it.
@@ -284,12 +534,103 @@ bool SDP3x::readProductID(uint32_t *pid, uint64_t *serial) {
 bool SDP3x::reset() {
     size_t written = 0;
     uint8_t status;
-    Wire.beginTransmission(SoftReset[0]);
-    written = Wire.write(SoftReset[1]);
-    status  = Wire.endTransmission();
+    this->wire->beginTransmission(SoftReset[0]);
+    written = this->wire->write(SoftReset[1]);
+    status  = this->wire->endTransmission();
     return (written == 1) && (status == 0);
 }
 
+/*  Enable or disable the CRC check of the pressure word in measurements
+
+    Skipping it trades error detection for less work per sample on short, trusted bus traces. The
+    CRC of temperature and scale words, and of product information, is always checked.
+    @param enabled - check the CRC of the pressure word (the default)
+*/
+void SDP3x::setPressureCRC(bool enabled) {
+    this->pressureCRC = enabled;
+}
+
+#ifdef SDP3X_STATS
+/*  Record the time taken by a transaction
+
+    @param start - the value of micros() when the transaction began
+*/
+void SDP3x::recordTime(unsigned long start) {
+    uint32_t elapsed = micros() - start;
+    if (elapsed < this->stats.minTime) {
+        this->stats.minTime = elapsed;
+    }
+    if (elapsed > this->stats.maxTime) {
+        this->stats.maxTime = elapsed;
+    }
+    this->stats.totalTime += elapsed;
+}
+
+/*  Record the outcome of a write transaction
+
+    @param start   - the value of micros() when the transaction began
+    @param success - true iff all ACKs received
+*/
+void SDP3x::recordWrite(unsigned long start, bool success) {
+    recordTime(start);
+    this->stats.writes++;
+    if (!success) {
+        this->stats.nacks++;
+    }
+}
+
+/*  Record the outcome of a read transaction
+
+    @param start   - the value of micros() when the transaction began
+    @param words   - the number of words requested
+    @param read    - the number of bytes actually received
+    @param success - true iff all words read and CRC passed
+*/
+void SDP3x::recordRead(unsigned long start, uint8_t words, size_t read, bool success) {
+    recordTime(start);
+    this->stats.reads++;
+    if (read == 0) {
+        this->stats.nacks++;
+    } else if (read != 3 * words) {
+        this->stats.shortReads++;
+    } else if (!success) {
+        this->stats.crcFailures++;
+    }
+}
+
+/*  Get the I2C transaction counters for this sensor
+
+    @returns the counters collected since construction or the last "resetStats"
+*/
+const SDP3xStats &SDP3x::getStats() {
+    return this->stats;
+}
+
+/*  Clear the I2C transaction counters for this sensor
+ */
+void SDP3x::resetStats() {
+    memset(&this->stats, 0, sizeof(this->stats));
+    this->stats.minTime = 0xFFFFFFFF;
+}
+#endif
+
+/*  Get the model of this sensor
+
+    Only valid once "begin" has succeeded.
+    @returns the model found by, or given to, "begin"
+*/
+Model SDP3x::getModel() {
+    return this->number;
+}
+
+/*  Get the I2C address of this sensor
+
+    @returns the Address value for I2C
+*/
+uint8_t SDP3x::getAddress() {
+    return this->addr;
+}
+
 /*  Get the Pressure Scale for this sensor
 
     @returns scale in units of 1/Pa
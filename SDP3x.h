@@ -28,10 +28,11 @@ extern "C" {
 #include <inttypes.h>
 }
 
-#if defined(ARDUINO) && (ARDUINO >= 100)
-#include <Arduino.h>
-#else
+/* Pre-1.0 Arduino cores only provide WProgram.h, all others (and host builds) use Arduino.h */
+#if defined(ARDUINO) && (ARDUINO < 100)
 #include <WProgram.h>
+#else
+#include <Arduino.h>
 #endif
 
 /* Wire is the Arduino library for I2C (aka Two-Wire Interface, TWI) */
@@ -61,6 +62,21 @@ namespace SDP3X {
     const uint8_t ReadInfo2[2]                = { 0xE1, 0x02 };
     const uint8_t SoftReset[2]                = { 0x00, 0x06 };
 
+    /*  Timing Parameters
+
+        TrigSettleTime - ms between a one-shot trigger and the reading being available
+        ContStartTime  - ms between starting continuous mode and the first reading being available
+        ContUpdateTime - ms between new readings in continuous mode
+        ContStopTime   - ms between stopping continuous mode and accepting a new command
+    */
+    const uint8_t TrigSettleTime = 45;
+    const uint8_t ContStartTime  = 8;
+    const uint8_t ContUpdateTime = 1;
+    const uint8_t ContStopTime   = 1;
+
+    /*  The most words read back in one go, ie. the product ID and serial number */
+    const uint8_t DataMaxWords = 6;
+
     /*  TempCompensation is used to set the temperature compensation mode for the sensor
 
         MassFlow     - Use this mode for Mass Flow applications
@@ -80,17 +96,125 @@ namespace SDP3X {
     const uint8_t SDP32_DiffScale = 240;
     const uint8_t SDP3X_TempScale = 200;
 
+    /*  SDP3xStats holds counters for I2C transactions
+
+        Only collected when SDP3X_STATS is defined for the whole build (ie. with a compiler flag),
+        so that it costs nothing otherwise. Times are measured with micros().
+    */
+    struct SDP3xStats {
+        /* Number of writeCommand transactions */
+        uint32_t writes;
+        /* Number of readData transactions, including poll attempts */
+        uint32_t reads;
+        /* Number of transactions the sensor did not acknowledge */
+        uint32_t nacks;
+        /* Number of reads that returned fewer bytes than requested */
+        uint32_t shortReads;
+        /* Number of reads that failed a CRC check */
+        uint32_t crcFailures;
+        /* Shortest, longest and total transaction times in us */
+        uint32_t minTime;
+        uint32_t maxTime;
+        uint32_t totalTime;
+    };
+
+    /* Flags for SDP3xSample */
+    const uint8_t SampleHasTemp = 0x01;
+    const uint8_t SampleMissed  = 0x02;
+
+    /*  SDP3xSample holds one raw reading and where it falls in the stream
+
+        "sequence" advances on every readSample attempt, including failed ones, so a jump between
+        two samples counts the readings lost in between. SampleMissed is also set on the first
+        sample after a failure. "temp" is only valid if SampleHasTemp is set.
+    */
+    struct SDP3xSample {
+        /* The value of micros() when the read began */
+        uint32_t time;
+        /* The raw pressure value */
+        int16_t pressure;
+        /* The raw temperature value */
+        int16_t temp;
+        /* The number of readSample attempts before this one, wrapping at 65536 */
+        uint16_t sequence;
+        /* Any of SampleHasTemp and SampleMissed */
+        uint8_t flags;
+    };
+
+    class SDP3x;
+
+    /*  ReadCallback is called by SDP3x::poll when a deferred read finishes
+
+        @param sensor  - the sensor that finished reading
+        @param success - true iff all words were read and CRC passed
+    */
+    typedef void (*ReadCallback)(SDP3x *sensor, bool success);
+
+    template <Model M, TempCompensation C, uint8_t A, class Bus, Bus &W> class SDP3xT;
+
     /* The SDP3x class can be used to interface with both the SDP31 and SDP32 sensors */
     class SDP3x {
+        template <Model M, TempCompensation C, uint8_t A, class Bus, Bus &W> friend class SDP3xT;
+
     private:
         /* The sensor model number*/
         Model number;
+        /* The I2C bus this device is on */
+        TwoWire *wire;
         /* The address of this device */
         uint8_t addr;
         /* The Temperature Compensation mode to use */
         TempCompensation comp;
-        /* Internal buffer to reuse for reads */
-        uint8_t buffer[13];
+        /* Check the CRC of the pressure word in measurements */
+        bool pressureCRC;
+        /* True iff "number" is known to be valid */
+        bool identified;
+        /* True iff "serialNumber" has been read since identification */
+        bool serialCached;
+        /* The cached manufacturer serial number */
+        uint64_t serialNumber;
+        /* Number of words requested by a pending deferred read, 0 if idle */
+        uint8_t pending;
+        /* Destinations for a pending deferred read */
+        int16_t *pendingOut[3];
+        /* Called when a pending deferred read completes */
+        ReadCallback callback;
+#ifdef SDP3X_ASYNC_I2C
+        /* True iff the transfer of a pending deferred read is running in the background */
+        bool requested;
+        /* The value of micros() when that transfer was started */
+        unsigned long requestTime;
+#endif
+        /* Sequence number of the next readSample attempt */
+        uint16_t sequence;
+        /* True iff a readSample attempt failed since the last successful one */
+        bool missed;
+#ifdef SDP3X_STATS
+        /* Counters for I2C transactions */
+        SDP3xStats stats;
+
+        /*  Record the time taken by a transaction
+
+            @param start - the value of micros() when the transaction began
+        */
+        void recordTime(unsigned long start);
+
+        /*  Record the outcome of a write transaction
+
+            @param start   - the value of micros() when the transaction began
+            @param success - true iff all ACKs received
+        */
+        void recordWrite(unsigned long start, bool success);
+
+        /*  Record the outcome of a read transaction
+
+            @param start   - the value of micros() when the transaction began
+            @param words   - the number of words requested
+            @param read    - the number of bytes actually received
+            @param success - true iff all words read and CRC passed
+        */
+        void recordRead(unsigned long start, uint8_t words, size_t read, bool success);
+#endif
 
         /*  Send a write command
 
@@ -101,19 +225,41 @@ namespace SDP3X {
 
         /*  Read data back from the device
 
-            @param words - the number of words to read
+            @param out         - an array of "words" destinations, NULL entries are not stored
+            @param words       - the number of words to read
+            @param verifyFirst - check the CRC of the first word, otherwise only the others
+            @returns true iff all words read and CRC passed
+        */
+        bool readData(int16_t *const out[], uint8_t words, bool verifyFirst);
+
+        /*  Verify and decode data already requested from the device
+
+            The CRC of each word is checked as it is read, and the words are only stored into
+            their destinations once every word has passed, ergo a failed read leaves every
+            destination untouched. This is a template so that SDP3xT can use an I2C driver that
+            does not derive from TwoWire.
+
+            @param Bus         - the type of the bus, only "read()" is used
+            @param wire        - the bus the data was requested on
+            @param out         - an array of "words" destinations, NULL entries are not stored
+            @param words       - the number of words requested
+            @param read        - the number of bytes actually received
+            @param verifyFirst - check the CRC of the first word, otherwise only the others
             @returns true iff all words read and CRC passed
         */
-        bool readData(uint8_t words);
+        template <class Bus>
+        static bool checkData(Bus &wire, int16_t *const out[], uint8_t words, size_t read,
+                              bool verifyFirst);
 
     public:
         /*  Constructor
 
             @param addr - the Address value for I2C
             @param comp - the Temperature Compensation Mode (Mass Flow or Differential Pressure)
+            @param wire - the I2C bus the sensor is on (ie. Wire1), SDP3xT supports other drivers
             @returns a new SDP3X as configured
         */
-        SDP3x(const uint8_t addr, TempCompensation comp);
+        SDP3x(const uint8_t addr, TempCompensation comp, TwoWire &wire = Wire);
 
         /*  Finish Initializing the sensor object
 
@@ -121,6 +267,14 @@ namespace SDP3X {
         */
         bool begin();
 
+        /*  Finish Initializing the sensor object for a known model
+
+            No I2C communication is made, which makes this suitable for waking from sleep.
+            @param model - the sensor model, as previously found by "begin()"
+            @returns true, iff everything went correctly
+        */
+        bool begin(Model model);
+
         /*  Begin taking continuous readings
 
             @param averaging - average samples until read occurs, otherwise read last value only
@@ -158,16 +312,100 @@ namespace SDP3X {
         */
         bool readMeasurement(int16_t *pressure, int16_t *temp, int16_t *scale);
 
+        /*  Collect a block of readings at a fixed interval.
+
+            This is meant for continuous mode. Each read is scheduled from the start of the
+            block rather than from the end of the previous read, so that jitter does not
+            accumulate. Collection stops at the first failed read, which is left untouched.
+
+            "temp" should be left NULL if not used. This will reduce read times.
+            @param pressure   - an array of at least "n" raw pressure values
+            @param temp       - if not null, an array of at least "n" raw temperature values
+            @param n          - the number of readings to collect
+            @param intervalUs - the time between readings in microseconds
+            @returns the number of readings collected, "n" iff everything went correctly
+        */
+        size_t readMeasurements(int16_t *pressure, int16_t *temp, size_t n, uint16_t intervalUs);
+
+        /*  Get a pending reading into a sample, with its time and sequence number.
+
+            The sample is written in place, and is only valid on success.
+            @param sample   - the sample to fill
+            @param withTemp - also read the temperature, otherwise only the pressure is read
+            @returns true, iff everything went correctly
+        */
+        bool readSample(SDP3xSample *sample, bool withTemp);
+
+        /*  Collect a block of samples at a fixed interval.
+
+            Scheduled as for "readMeasurements", and collection stops at the first failed read.
+            @param samples    - an array of at least "n" samples
+            @param n          - the number of samples to collect
+            @param intervalUs - the time between readings in microseconds
+            @param withTemp   - also read the temperature, otherwise only the pressure is read
+            @returns the number of samples collected, "n" iff everything went correctly
+        */
+        size_t readSamples(SDP3xSample *samples, size_t n, uint16_t intervalUs, bool withTemp);
+
+        /*  Start a deferred reading, retried by "poll" while the sensor NACKs.
+
+            Nothing is sent until "poll" is called. While the sensor NACKs its address (ie. a
+            triggered measurement without clock stretching is not ready yet), the read stays
+            pending. Unless SDP3X_ASYNC_I2C is defined, every "poll" blocks in Wire.requestFrom,
+            briefly for a NACK and for the whole transfer once data is returned.
+
+            Both "temp" and "scale" should be left NULL if not used. This will reduce read times.
+            Nothing is stored unless every CRC passes, so a failed read leaves all outputs as-is.
+            @param pressure - a pointer to store the raw pressure value
+            @param temp     - a pointer to store the raw temperature value
+            @param scale    - a pointer to store the pressure scaling factor
+            @param callback - if not null, called once the read completes
+            @returns true, iff no other read was already pending
+        */
+        bool beginRead(int16_t *pressure, int16_t *temp, int16_t *scale, ReadCallback callback);
+
+        /*  Attempt a pending deferred reading.
+
+            Blocks for one Wire.requestFrom. If the sensor NACKs, the read stays pending.
+
+            When SDP3X_ASYNC_I2C is defined for the whole build, the bus must have the
+            non-blocking "sendRequest" and "done" of i2c_t3 (ie. Teensy 3.x and LC). Then "poll"
+            never waits on the bus: it starts the transfer and returns, and later calls return at
+            once until the bus hardware has finished it. Nothing else may use the bus meanwhile.
+            @returns true, iff a pending read completed during this call (successfully or not)
+        */
+        bool poll();
+
+        /*  Abandon a pending deferred reading, without calling its callback
+
+            A transfer already running in the background is waited for, so the bus is free after.
+            @returns true, iff a read was pending
+        */
+        bool cancelRead();
+
+        /*  Check for a pending deferred reading
+
+            @returns true, iff a read was started and has not yet completed
+        */
+        bool isBusy();
+
         /*  Read back the sensor's internal information
 
             If a serial number is not needed, "serial" should be set to NULL. This will reduce read
-           times.
+           times. Once "begin" has succeeded, the product ID and serial number are only read from
+           the sensor the first time.
             @param pid     - a pointer to store the 32-bit product ID
             @param serial  - if not null, a pointer to store the 64-bit manufacturer serial number
             @returns true, iff everything went correctly
         */
         bool readProductID(uint32_t *pid, uint64_t *serial);
 
+        /*  Check that a device acknowledges this address, without sending it a command
+
+            @returns true, iff the address was acknowledged
+        */
+        bool probe();
+
         /*  Reset the device to default settings
 
             WARNING: This will reset all other I2C devices that support it.
@@ -175,6 +413,40 @@ namespace SDP3X {
         */
         bool reset();
 
+        /*  Enable or disable the CRC check of the pressure word in measurements
+
+            Skipping it trades error detection for less work per sample on short, trusted bus
+            traces. The CRC of temperature and scale words, and of product information, is always
+            checked.
+            @param enabled - check the CRC of the pressure word (the default)
+        */
+        void setPressureCRC(bool enabled);
+
+#ifdef SDP3X_STATS
+        /*  Get the I2C transaction counters for this sensor
+
+            @returns the counters collected since construction or the last "resetStats"
+        */
+        const SDP3xStats &getStats();
+
+        /*  Clear the I2C transaction counters for this sensor
+         */
+        void resetStats();
+#endif
+
+        /*  Get the model of this sensor
+
+            Only valid once "begin" has succeeded.
+            @returns the model found by, or given to, "begin"
+        */
+        Model getModel();
+
+        /*  Get the I2C address of this sensor
+
+            @returns the Address value for I2C
+        */
+        uint8_t getAddress();
+
         /*  Get the Pressure Scale for this sensor
 
             @returns scale in units of 1/Pa
@@ -188,7 +460,7 @@ namespace SDP3X {
         uint8_t getTemperatureScale();
     };
 
-    /*  CRC-8 Lookup Table
+    /*  CRC-8, as used by the sensor
 
         Settings:
         INIT           - 0xFF
@@ -197,27 +469,97 @@ namespace SDP3X {
         Reflect Output - No
         Final XOR      - 0x00
 
-        Source: http://www.sunshine2k.de/coding/javascript/crc/crc_js.html
+        The table is defined once in SDP3x.cpp. For small targets, one of these may be defined for
+        the whole build (ie. with a compiler flag):
+        SDP3X_CRC_PROGMEM - keep the 256 byte table in flash on AVR, rather than in SRAM
+        SDP3X_CRC_NIBBLE  - use a 16 byte table, with two lookups per byte
+        SDP3X_CRC_BITWISE - use no table, with eight shifts per byte
     */
-    const uint8_t CRC_LUT[256] =
-        { 0x00, 0x31, 0x62, 0x53, 0xC4, 0xF5, 0xA6, 0x97, 0xB9, 0x88, 0xDB, 0xEA, 0x7D, 0x4C, 0x1F,
-          0x2E, 0x43, 0x72, 0x21, 0x10, 0x87, 0xB6, 0xE5, 0xD4, 0xFA, 0xCB, 0x98, 0xA9, 0x3E, 0x0F,
-          0x5C, 0x6D, 0x86, 0xB7, 0xE4, 0xD5, 0x42, 0x73, 0x20, 0x11, 0x3F, 0x0E, 0x5D, 0x6C, 0xFB,
-          0xCA, 0x99, 0xA8, 0xC5, 0xF4, 0xA7, 0x96, 0x01, 0x30, 0x63, 0x52, 0x7C, 0x4D, 0x1E, 0x2F,
-          0xB8, 0x89, 0xDA, 0xEB, 0x3D, 0x0C, 0x5F, 0x6E, 0xF9, 0xC8, 0x9B, 0xAA, 0x84, 0xB5, 0xE6,
-          0xD7, 0x40, 0x71, 0x22, 0x13, 0x7E, 0x4F, 0x1C, 0x2D, 0xBA, 0x8B, 0xD8, 0xE9, 0xC7, 0xF6,
-          0xA5, 0x94, 0x03, 0x32, 0x61, 0x50, 0xBB, 0x8A, 0xD9, 0xE8, 0x7F, 0x4E, 0x1D, 0x2C, 0x02,
-          0x33, 0x60, 0x51, 0xC6, 0xF7, 0xA4, 0x95, 0xF8, 0xC9, 0x9A, 0xAB, 0x3C, 0x0D, 0x5E, 0x6F,
-          0x41, 0x70, 0x23, 0x12, 0x85, 0xB4, 0xE7, 0xD6, 0x7A, 0x4B, 0x18, 0x29, 0xBE, 0x8F, 0xDC,
-          0xED, 0xC3, 0xF2, 0xA1, 0x90, 0x07, 0x36, 0x65, 0x54, 0x39, 0x08, 0x5B, 0x6A, 0xFD, 0xCC,
-          0x9F, 0xAE, 0x80, 0xB1, 0xE2, 0xD3, 0x44, 0x75, 0x26, 0x17, 0xFC, 0xCD, 0x9E, 0xAF, 0x38,
-          0x09, 0x5A, 0x6B, 0x45, 0x74, 0x27, 0x16, 0x81, 0xB0, 0xE3, 0xD2, 0xBF, 0x8E, 0xDD, 0xEC,
-          0x7B, 0x4A, 0x19, 0x28, 0x06, 0x37, 0x64, 0x55, 0xC2, 0xF3, 0xA0, 0x91, 0x47, 0x76, 0x25,
-          0x14, 0x83, 0xB2, 0xE1, 0xD0, 0xFE, 0xCF, 0x9C, 0xAD, 0x3A, 0x0B, 0x58, 0x69, 0x04, 0x35,
-          0x66, 0x57, 0xC0, 0xF1, 0xA2, 0x93, 0xBD, 0x8C, 0xDF, 0xEE, 0x79, 0x48, 0x1B, 0x2A, 0xC1,
-          0xF0, 0xA3, 0x92, 0x05, 0x34, 0x67, 0x56, 0x78, 0x49, 0x1A, 0x2B, 0xBC, 0x8D, 0xDE, 0xEF,
-          0x82, 0xB3, 0xE0, 0xD1, 0x46, 0x77, 0x24, 0x15, 0x3B, 0x0A, 0x59, 0x68, 0xFF, 0xCE, 0x9D,
-          0xAC };
+#if defined(SDP3X_CRC_BITWISE)
+    inline uint8_t crc8(uint8_t crc, uint8_t data) {
+        uint8_t i;
+        crc ^= data;
+        for (i = 0; i < 8; i++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+        }
+        return crc;
+    }
+#elif defined(SDP3X_CRC_NIBBLE)
+    extern const uint8_t CRC_NIBBLE[16];
+
+    inline uint8_t crc8(uint8_t crc, uint8_t data) {
+        crc ^= data;
+        crc = (uint8_t)(crc << 4) ^ CRC_NIBBLE[crc >> 4];
+        return (uint8_t)(crc << 4) ^ CRC_NIBBLE[crc >> 4];
+    }
+#elif defined(SDP3X_CRC_PROGMEM)
+    extern const uint8_t CRC_LUT[256] PROGMEM;
+
+    inline uint8_t crc8(uint8_t crc, uint8_t data) {
+        return pgm_read_byte(&CRC_LUT[crc ^ data]);
+    }
+#else
+    extern const uint8_t CRC_LUT[256];
+
+    inline uint8_t crc8(uint8_t crc, uint8_t data) {
+        return CRC_LUT[crc ^ data];
+    }
+#endif
+
+    /*  Verify and decode data already requested from the device
+
+        The CRC of each word is checked as it is read, and the words are only stored into their
+        destinations once every word has passed, ergo a failed read leaves every destination
+        untouched.
+
+        @param Bus         - the type of the bus, only "read()" is used
+        @param wire        - the bus the data was requested on
+        @param out         - an array of "words" destinations, NULL entries are checked only
+        @param words       - the number of words requested
+        @param read        - the number of bytes actually received
+        @param verifyFirst - check the CRC of the first word, otherwise only the others
+        @returns true iff all words read and CRC passed
+    */
+    template <class Bus>
+    bool SDP3x::checkData(Bus &wire, int16_t *const out[], uint8_t words, size_t read,
+                          bool verifyFirst) {
+        int16_t values[DataMaxWords];
+        uint8_t msb;
+        uint8_t lsb;
+        uint8_t crc;
+        uint8_t i;
+        /*  We should have read the requested number of bytes.
+            If not, we need to clear the bytes read anyways.
+        */
+        if ((read != 3 * words) || (words > DataMaxWords)) {
+            for (; read > 0; read--) {
+                wire.read();
+            }
+            return false;
+        }
+        /*  Calculate CRC while reading bytes
+
+            Adapted from:
+            http://www.sunshine2k.de/articles/coding/crc/understanding_crc.html
+        */
+        for (i = 0; i < words; i++) {
+            msb = wire.read();
+            lsb = wire.read();
+            crc = wire.read();
+            // The CRC byte only covers the current word, ergo it restarts at 0xFF every time
+            if (((i != 0) || verifyFirst) && (crc != crc8(crc8(0xFF, msb), lsb))) {
+                return false;
+            }
+            values[i] = (int16_t)(((uint16_t)msb << 8) | lsb);
+        }
+        // Only store once everything passed, so a bad word never leaves a partial update behind
+        for (i = 0; i < words; i++) {
+            if (out[i] != NULL) {
+                *out[i] = values[i];
+            }
+        }
+        return true;
+    }
 } // namespace SDP3X
 
 #endif
@@ -0,0 +1,113 @@
+/*
+    SDP3xAccumulator.cpp - Windowed pressure statistics from raw SDP3x readings.
+
+    Copyright (c) 2018 Bryan T. Meyers
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+    and associated documentation files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+    BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "SDP3xAccumulator.h"
+#include <math.h>
+
+using namespace SDP3X;
+
+/*  Constructor
+
+    @param scale  - the pressure scaling factor, from getPressureScale
+    @param window - the readings per window, 0 to close windows only with "close"
+    @returns a new SDP3xAccumulator, with an empty window
+*/
+SDP3xAccumulator::SDP3xAccumulator(uint8_t scale, uint16_t window) {
+    this->scale          = scale;
+    this->window         = window;
+    this->count          = 0;
+    this->low            = 0;
+    this->high           = 0;
+    this->sum            = 0;
+    this->sumSquares     = 0;
+    this->summary.min    = 0;
+    this->summary.max    = 0;
+    this->summary.mean   = 0;
+    this->summary.stddev = 0;
+    this->summary.rms    = 0;
+    this->summary.count  = 0;
+}
+
+/*  Add a reading to the current window, closing it once full
+
+    A full window of 65535 readings is closed before the reading is added, which then starts
+    the next window, so this also returns true then.
+    @param pressure - the raw pressure value
+    @returns true, iff a window was closed, ie. "getSummary" has new statistics
+*/
+bool SDP3xAccumulator::update(int16_t pressure) {
+    bool closed = false;
+    if (this->count == 0xFFFF) {
+        // The sums are only exact up to 65535 readings
+        closed = close();
+    }
+    if ((this->count == 0) || (pressure < this->low)) {
+        this->low = pressure;
+    }
+    if ((this->count == 0) || (pressure > this->high)) {
+        this->high = pressure;
+    }
+    this->sum += pressure;
+    // The square of any int16_t fits in 31 bits
+    this->sumSquares += (uint32_t)((int32_t)pressure * pressure);
+    this->count++;
+    if (this->count == this->window) {
+        return close() || closed;
+    }
+    return closed;
+}
+
+/*  Close the current window now (ie. on a timer), and start another
+
+    A window is also closed if it would exceed 65535 readings.
+    @returns true, iff the window held any readings
+*/
+bool SDP3xAccumulator::close() {
+    uint64_t spread;
+    float n;
+    float ns;
+    if (this->count == 0) {
+        return false;
+    }
+    // n * sum(x^2) - sum(x)^2 is exact in 64 bits, and never negative
+    spread = this->count * this->sumSquares - (uint64_t)((int64_t)this->sum * this->sum);
+    n      = (float)this->count;
+    ns     = n * this->scale;
+
+    this->summary.min    = (float)this->low / this->scale;
+    this->summary.max    = (float)this->high / this->scale;
+    this->summary.mean   = (float)this->sum / ns;
+    this->summary.stddev = sqrtf((float)spread) / ns;
+    this->summary.rms    = sqrtf((float)this->sumSquares / n) / this->scale;
+    this->summary.count  = this->count;
+    this->count          = 0;
+    this->sum            = 0;
+    this->sumSquares     = 0;
+    return true;
+}
+
+/*  Get the statistics of the last closed window
+
+    @returns the summary, with a count of 0 if no window has closed
+*/
+const SDP3xSummary &SDP3xAccumulator::getSummary() {
+    return this->summary;
+}
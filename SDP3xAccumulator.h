@@ -0,0 +1,100 @@
+/*
+    SDP3xAccumulator.h - Windowed pressure statistics from raw SDP3x readings.
+
+    Copyright (c) 2018 Bryan T. Meyers
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+    and associated documentation files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+    BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SDP3X_ACCUMULATOR_H
+#define SDP3X_ACCUMULATOR_H
+
+#include "SDP3x.h"
+
+namespace SDP3X {
+    /* SDP3xSummary holds the statistics of a closed window, in Pa */
+    struct SDP3xSummary {
+        /* Smallest and largest pressure */
+        float min;
+        float max;
+        /* Mean pressure */
+        float mean;
+        /* Population standard deviation of pressure */
+        float stddev;
+        /* Root mean square of pressure */
+        float rms;
+        /* Number of readings in the window */
+        uint16_t count;
+    };
+
+    /*  The SDP3xAccumulator class collects statistics over tumbling windows of raw readings
+
+        Each update only adds and compares integers: the sum in 32 bits and the sum of squares in
+        64 bits are exact for up to 65535 readings (ie. 1kHz for 60s), so the variance has no
+        rounding until the window closes. Conversion to Pa happens only then.
+    */
+    class SDP3xAccumulator {
+    private:
+        /* The pressure scaling factor, from getPressureScale */
+        uint8_t scale;
+        /* Readings per window */
+        uint16_t window;
+        /* Readings in the current window */
+        uint16_t count;
+        /* Smallest and largest raw readings in the current window */
+        int16_t low;
+        int16_t high;
+        /* Sum of raw readings in the current window */
+        int32_t sum;
+        /* Sum of squared raw readings in the current window */
+        uint64_t sumSquares;
+        /* Statistics of the last closed window */
+        SDP3xSummary summary;
+
+    public:
+        /*  Constructor
+
+            @param scale  - the pressure scaling factor, from getPressureScale
+            @param window - the readings per window, 0 to close windows only with "close"
+            @returns a new SDP3xAccumulator, with an empty window
+        */
+        SDP3xAccumulator(uint8_t scale, uint16_t window);
+
+        /*  Add a reading to the current window, closing it once full
+
+            A full window of 65535 readings is closed before the reading is added, which then starts
+            the next window, so this also returns true then.
+            @param pressure - the raw pressure value
+            @returns true, iff a window was closed, ie. "getSummary" has new statistics
+        */
+        bool update(int16_t pressure);
+
+        /*  Close the current window now (ie. on a timer), and start another
+
+            A window is also closed if it would exceed 65535 readings.
+            @returns true, iff the window held any readings
+        */
+        bool close();
+
+        /*  Get the statistics of the last closed window
+
+            @returns the summary, with a count of 0 if no window has closed
+        */
+        const SDP3xSummary &getSummary();
+    };
+} // namespace SDP3X
+
+#endif
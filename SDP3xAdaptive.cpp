@@ -0,0 +1,151 @@
+/*
+    SDP3xAdaptive.cpp - Continuous mode that follows the read rate of SDP3x sensors.
+
+    Copyright (c) 2018 Bryan T. Meyers
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+    and associated documentation files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+    BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "SDP3xAdaptive.h"
+
+using namespace SDP3X;
+
+/* Longest interval counted, so one long pause cannot overflow the average */
+const unsigned long AdaptiveMaxInterval = 1000000;
+
+/*  Constructor
+
+    @param sensor - the sensor to sample, which must outlive this object
+    @param fastMs - read intervals in ms below which averaging stops
+    @param slowMs - read intervals in ms above which averaging resumes, above "fastMs"
+    @returns a new SDP3xAdaptive, not yet started
+*/
+SDP3xAdaptive::SDP3xAdaptive(SDP3x &sensor, uint16_t fastMs, uint16_t slowMs) : schedule(sensor) {
+    this->interval  = 0;
+    this->last      = 0;
+    this->restartAt = 0;
+    this->fast      = fastMs * 1000UL;
+    this->slow      = slowMs * 1000UL;
+    this->averaging = true;
+    this->measured  = false;
+    this->switching = false;
+}
+
+/*  Stop continuous mode, to be restarted in the other mode once stopped
+
+    If the stop fails, the mode is kept, but the restart still follows so that reads resume once
+    the sensor answers again.
+    @returns true, iff continuous mode was stopped
+*/
+bool SDP3xAdaptive::toggle() {
+    bool stopped = this->schedule.stopContinuous();
+    if (stopped) {
+        this->averaging = !this->averaging;
+    }
+    this->restartAt = micros() + ContStopTime * 1000UL;
+    this->switching = true;
+    // The restart gap says nothing about the read rate
+    this->measured = false;
+    return stopped;
+}
+
+/*  Begin taking continuous readings
+
+    @param averaging - the mode to start in, until the read rate is known
+    @returns true, iff everything went correctly
+*/
+bool SDP3xAdaptive::start(bool averaging) {
+    this->averaging = averaging;
+    this->interval  = 0;
+    this->measured  = false;
+    this->switching = false;
+    return this->schedule.startContinuous(averaging);
+}
+
+/*  Disable continuous measurements
+
+    @returns true, iff everything went correctly
+*/
+bool SDP3xAdaptive::stop() {
+    this->switching = false;
+    return this->schedule.stopContinuous();
+}
+
+/*  Get a fresh reading, if there is one, and switch modes if the read rate calls for it
+
+    Both "temp" and "scale" should be left NULL if not used. This will reduce read times.
+    @param pressure - a pointer to store the raw pressure value
+    @param temp     - a pointer to store the raw temperature value
+    @param scale    - a pointer to store the pressure scaling factor
+    @returns true, iff a fresh reading was read correctly
+*/
+bool SDP3xAdaptive::read(int16_t *pressure, int16_t *temp, int16_t *scale) {
+    unsigned long now;
+    unsigned long sample;
+    if (this->switching) {
+        if ((long)(micros() - this->restartAt) < 0) {
+            return false;
+        }
+        // The first reading in the new mode follows after ContStartTime
+        if (this->schedule.startContinuous(this->averaging)) {
+            this->switching = false;
+        } else {
+            // Make sure the sensor is idle (ie. a failed stop left it running), then retry
+            this->schedule.stopContinuous();
+            this->restartAt = micros() + ContStopTime * 1000UL;
+        }
+        return false;
+    }
+    if (!this->schedule.read(pressure, temp, scale)) {
+        return false;
+    }
+    now = micros();
+    if (this->measured) {
+        sample = now - this->last;
+        if (sample > AdaptiveMaxInterval) {
+            sample = AdaptiveMaxInterval;
+        }
+        // Exponential moving average over about 8 reads, seeded by the first interval
+        if (this->interval == 0) {
+            this->interval = sample;
+        } else {
+            this->interval = this->interval - (this->interval >> 3) + (sample >> 3);
+        }
+        if (this->averaging ? (this->interval < this->fast) : (this->interval > this->slow)) {
+            toggle();
+            return true;
+        }
+    }
+    this->last     = now;
+    this->measured = true;
+    return true;
+}
+
+/*  Check the current mode
+
+    @returns true, iff the sensor is averaging, or will be once restarted
+*/
+bool SDP3xAdaptive::isAveraging() {
+    return this->averaging;
+}
+
+/*  Get the smoothed interval between reads
+
+    @returns the interval in us, 0 until two reads have been made
+*/
+unsigned long SDP3xAdaptive::getInterval() {
+    return this->interval;
+}
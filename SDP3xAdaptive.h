@@ -0,0 +1,119 @@
+/*
+    SDP3xAdaptive.h - Continuous mode that follows the read rate of SDP3x sensors.
+
+    Copyright (c) 2018 Bryan T. Meyers
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+    and associated documentation files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+    BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SDP3X_ADAPTIVE_H
+#define SDP3X_ADAPTIVE_H
+
+#include "SDP3xScheduler.h"
+
+namespace SDP3X {
+    /* Default read intervals in ms below which averaging stops, and above which it resumes */
+    const uint16_t AdaptiveFastTime = 10;
+    const uint16_t AdaptiveSlowTime = 40;
+
+    /*  The SDP3xAdaptive class switches continuous mode between averaging and last value
+
+        The interval between successful reads is smoothed over about 8 reads. Averaging is used
+        while reads are slower than "slowMs", for free noise reduction, and last value while they
+        are faster than "fastMs", for the least latency. Between the two, the mode is kept, so a
+        rate near either threshold does not cause repeated restarts. A switch stops continuous
+        mode and restarts it without blocking, so no reading is available for about
+        ContStopTime + ContStartTime. If the sensor does not answer the stop or the restart, the
+        restart is retried every ContStopTime from "read", so readings resume on their own once
+        it answers again.
+    */
+    class SDP3xAdaptive {
+    private:
+        /* Tracks when the next reading is ready */
+        SDP3xScheduler schedule;
+        /* Smoothed interval between reads in us */
+        unsigned long interval;
+        /* Time in us of the last successful read */
+        unsigned long last;
+        /* Time in us at which continuous mode may be restarted */
+        unsigned long restartAt;
+        /* Read intervals in us below which averaging stops, and above which it resumes */
+        unsigned long fast;
+        unsigned long slow;
+        /* True iff the current mode is averaging */
+        bool averaging;
+        /* True iff "last" is valid */
+        bool measured;
+        /* True iff continuous mode has been stopped to switch modes */
+        bool switching;
+
+        /*  Stop continuous mode, to be restarted in the other mode once stopped
+
+            If the stop fails, the mode is kept, but the restart still follows so that reads
+            resume once the sensor answers again.
+            @returns true, iff continuous mode was stopped
+        */
+        bool toggle();
+
+    public:
+        /*  Constructor
+
+            @param sensor - the sensor to sample, which must outlive this object
+            @param fastMs - read intervals in ms below which averaging stops
+            @param slowMs - read intervals in ms above which averaging resumes, above "fastMs"
+            @returns a new SDP3xAdaptive, not yet started
+        */
+        SDP3xAdaptive(SDP3x &sensor, uint16_t fastMs = AdaptiveFastTime,
+                      uint16_t slowMs = AdaptiveSlowTime);
+
+        /*  Begin taking continuous readings
+
+            @param averaging - the mode to start in, until the read rate is known
+            @returns true, iff everything went correctly
+        */
+        bool start(bool averaging);
+
+        /*  Disable continuous measurements
+
+            @returns true, iff everything went correctly
+        */
+        bool stop();
+
+        /*  Get a fresh reading, if there is one, and switch modes if the read rate calls for it
+
+            Both "temp" and "scale" should be left NULL if not used. This will reduce read times.
+            @param pressure - a pointer to store the raw pressure value
+            @param temp     - a pointer to store the raw temperature value
+            @param scale    - a pointer to store the pressure scaling factor
+            @returns true, iff a fresh reading was read correctly
+        */
+        bool read(int16_t *pressure, int16_t *temp, int16_t *scale);
+
+        /*  Check the current mode
+
+            @returns true, iff the sensor is averaging, or will be once restarted
+        */
+        bool isAveraging();
+
+        /*  Get the smoothed interval between reads
+
+            @returns the interval in us, 0 until two reads have been made
+        */
+        unsigned long getInterval();
+    };
+} // namespace SDP3X
+
+#endif
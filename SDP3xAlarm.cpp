@@ -0,0 +1,157 @@
+/*
+    SDP3xAlarm.cpp - Threshold and rate alarms on raw SDP3x readings.
+
+    Copyright (c) 2018 Bryan T. Meyers
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+    and associated documentation files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+    BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "SDP3xAlarm.h"
+
+using namespace SDP3X;
+
+/*  Convert a pressure to raw counts, rounding and saturating to the raw range
+
+    @param pascal - the pressure in Pa
+    @param scale  - the pressure scaling factor
+    @returns the nearest raw value
+*/
+static int16_t toCounts(float pascal, uint8_t scale) {
+    float counts = pascal * scale;
+    if (counts >= 32767.0f) {
+        return 32767;
+    }
+    if (counts <= -32768.0f) {
+        return -32768;
+    }
+    return (int16_t)((counts < 0) ? (counts - 0.5f) : (counts + 0.5f));
+}
+
+/*  Constructor
+
+    @param scale - the pressure scaling factor, from getPressureScale
+    @returns a new SDP3xAlarm, with no alarms set
+*/
+SDP3xAlarm::SDP3xAlarm(uint8_t scale) {
+    this->scale      = scale;
+    this->enabled    = 0;
+    this->active     = 0;
+    this->aboveRaise = 0;
+    this->aboveClear = 0;
+    this->belowRaise = 0;
+    this->belowClear = 0;
+    this->rate       = 0;
+    this->last       = 0;
+    this->primed     = false;
+    this->callback   = NULL;
+}
+
+/*  Raise AlarmAbove while the pressure is above a threshold
+
+    @param pascal     - the threshold in Pa
+    @param hysteresis - how far below the threshold the pressure must fall to clear, in Pa
+*/
+void SDP3xAlarm::setAbove(float pascal, float hysteresis) {
+    this->aboveRaise = toCounts(pascal, this->scale);
+    this->aboveClear = toCounts(pascal - hysteresis, this->scale);
+    this->enabled |= AlarmAbove;
+}
+
+/*  Raise AlarmBelow while the pressure is below a threshold (ie. flow loss)
+
+    @param pascal     - the threshold in Pa
+    @param hysteresis - how far above the threshold the pressure must rise to clear, in Pa
+*/
+void SDP3xAlarm::setBelow(float pascal, float hysteresis) {
+    this->belowRaise = toCounts(pascal, this->scale);
+    this->belowClear = toCounts(pascal + hysteresis, this->scale);
+    this->enabled |= AlarmBelow;
+}
+
+/*  Raise AlarmRate while the pressure changes too quickly, in either direction
+
+    @param pascal - the largest change between readings in Pa
+*/
+void SDP3xAlarm::setRate(float pascal) {
+    this->rate = toCounts(pascal, this->scale);
+    this->enabled |= AlarmRate;
+}
+
+/*  Stop checking some alarms, clearing them
+
+    @param alarms - any of AlarmAbove, AlarmBelow and AlarmRate
+*/
+void SDP3xAlarm::disable(uint8_t alarms) {
+    this->enabled &= ~alarms;
+    this->active &= ~alarms;
+}
+
+/*  Set the function called when the active alarms change
+
+    @param callback - the function to call, NULL for none
+*/
+void SDP3xAlarm::setCallback(AlarmCallback callback) {
+    this->callback = callback;
+}
+
+/*  Check a reading against every alarm set
+
+    @param pressure - the raw pressure value
+    @returns the alarms now active
+*/
+uint8_t SDP3xAlarm::update(int16_t pressure) {
+    uint8_t now = this->active;
+    int32_t change;
+    if (this->enabled & AlarmAbove) {
+        if (pressure > this->aboveRaise) {
+            now |= AlarmAbove;
+        } else if (pressure <= this->aboveClear) {
+            now &= ~AlarmAbove;
+        }
+    }
+    if (this->enabled & AlarmBelow) {
+        if (pressure < this->belowRaise) {
+            now |= AlarmBelow;
+        } else if (pressure >= this->belowClear) {
+            now &= ~AlarmBelow;
+        }
+    }
+    if ((this->enabled & AlarmRate) && this->primed) {
+        change = (int32_t)pressure - this->last;
+        if ((change > this->rate) || (change < -this->rate)) {
+            now |= AlarmRate;
+        } else {
+            now &= ~AlarmRate;
+        }
+    }
+    this->last   = pressure;
+    this->primed = true;
+    if (now != this->active) {
+        this->active = now;
+        if (this->callback != NULL) {
+            this->callback(this, now);
+        }
+    }
+    return now;
+}
+
+/*  Get the alarms currently active
+
+    @returns any of AlarmAbove, AlarmBelow and AlarmRate
+*/
+uint8_t SDP3xAlarm::getActive() {
+    return this->active;
+}
@@ -0,0 +1,128 @@
+/*
+    SDP3xAlarm.h - Threshold and rate alarms on raw SDP3x readings.
+
+    Copyright (c) 2018 Bryan T. Meyers
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+    and associated documentation files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+    BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SDP3X_ALARM_H
+#define SDP3X_ALARM_H
+
+#include "SDP3x.h"
+
+namespace SDP3X {
+    /* Alarm flags */
+    const uint8_t AlarmAbove = 0x01;
+    const uint8_t AlarmBelow = 0x02;
+    const uint8_t AlarmRate  = 0x04;
+
+    class SDP3xAlarm;
+
+    /*  AlarmCallback is called by SDP3xAlarm::update when the set of active alarms changes
+
+        @param alarm  - the alarm engine that changed
+        @param active - the alarms now active, any of AlarmAbove, AlarmBelow and AlarmRate
+    */
+    typedef void (*AlarmCallback)(SDP3xAlarm *alarm, uint8_t active);
+
+    /*  The SDP3xAlarm class raises alarms from raw pressure readings
+
+        Thresholds are converted to raw counts when they are set, so each update only compares
+        integers and is cheap. Readings still have to be taken from loop or a task (ie. with
+        SDP3xSampleRing::fill), never from an ISR, since they need the I2C bus. Level alarms clear
+        only once the pressure is back past the threshold by the hysteresis. The rate alarm
+        compares the change since the previous reading, so it assumes a fixed sample period.
+    */
+    class SDP3xAlarm {
+    private:
+        /* The pressure scaling factor, from getPressureScale */
+        uint8_t scale;
+        /* Alarms that have been set */
+        uint8_t enabled;
+        /* Alarms currently active */
+        uint8_t active;
+        /* Raw counts above which AlarmAbove is raised, and at or below which it clears */
+        int16_t aboveRaise;
+        int16_t aboveClear;
+        /* Raw counts below which AlarmBelow is raised, and at or above which it clears */
+        int16_t belowRaise;
+        int16_t belowClear;
+        /* Largest change in raw counts between readings before AlarmRate is raised */
+        int32_t rate;
+        /* The previous raw pressure value */
+        int16_t last;
+        /* True iff "last" is valid */
+        bool primed;
+        /* Called when the active alarms change */
+        AlarmCallback callback;
+
+    public:
+        /*  Constructor
+
+            @param scale - the pressure scaling factor, from getPressureScale
+            @returns a new SDP3xAlarm, with no alarms set
+        */
+        SDP3xAlarm(uint8_t scale);
+
+        /*  Raise AlarmAbove while the pressure is above a threshold
+
+            @param pascal     - the threshold in Pa
+            @param hysteresis - how far below the threshold the pressure must fall to clear, in Pa
+        */
+        void setAbove(float pascal, float hysteresis);
+
+        /*  Raise AlarmBelow while the pressure is below a threshold (ie. flow loss)
+
+            @param pascal     - the threshold in Pa
+            @param hysteresis - how far above the threshold the pressure must rise to clear, in Pa
+        */
+        void setBelow(float pascal, float hysteresis);
+
+        /*  Raise AlarmRate while the pressure changes too quickly, in either direction
+
+            @param pascal - the largest change between readings in Pa
+        */
+        void setRate(float pascal);
+
+        /*  Stop checking some alarms, clearing them
+
+            @param alarms - any of AlarmAbove, AlarmBelow and AlarmRate
+        */
+        void disable(uint8_t alarms);
+
+        /*  Set the function called when the active alarms change
+
+            @param callback - the function to call, NULL for none
+        */
+        void setCallback(AlarmCallback callback);
+
+        /*  Check a reading against every alarm set
+
+            @param pressure - the raw pressure value
+            @returns the alarms now active
+        */
+        uint8_t update(int16_t pressure);
+
+        /*  Get the alarms currently active
+
+            @returns any of AlarmAbove, AlarmBelow and AlarmRate
+        */
+        uint8_t getActive();
+    };
+} // namespace SDP3X
+
+#endif
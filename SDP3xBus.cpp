@@ -0,0 +1,246 @@
+/*
+    SDP3xBus.cpp - Group scheduling for multiple SDP3x sensors on one I2C bus.
+
+    Copyright (c) 2018 Bryan T. Meyers
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+    and associated documentation files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+    BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "SDP3xBus.h"
+
+using namespace SDP3X;
+
+/*  Constructor
+
+    @returns a new, empty SDP3xBus
+*/
+SDP3xBus::SDP3xBus() {
+    this->count = 0;
+    this->ready = 0;
+    this->armed = false;
+}
+
+/*  Add a sensor to this group
+
+    The sensor is not copied, so it must outlive the group.
+    @param sensor - the sensor to add
+    @returns true, iff there was room for the sensor
+*/
+bool SDP3xBus::add(SDP3x *sensor) {
+    if ((sensor == NULL) || (this->count >= BusMaxSensors)) {
+        return false;
+    }
+    this->sensors[this->count] = sensor;
+    this->count++;
+    return true;
+}
+
+/*  Get the number of sensors in this group
+
+    @returns the number of sensors added so far
+*/
+uint8_t SDP3xBus::size() {
+    return this->count;
+}
+
+/*  Get a sensor from this group
+
+    @param index - the position of the sensor, in the order it was added
+    @returns the sensor, or NULL if index is out of range
+*/
+SDP3x *SDP3xBus::get(uint8_t index) {
+    if (index >= this->count) {
+        return NULL;
+    }
+    return this->sensors[index];
+}
+
+/*  Find which candidate sensors are present, and add them once initialized
+
+    Candidates are probed with an empty write, which only needs an ACK, so unpopulated addresses
+    cost a single address byte. Only the sensors that answered are then identified with "begin".
+    The group holds at most BusMaxSensors sensors in total, even if the candidates are spread over
+    several buses, so candidates are taken in order and discovery stops once the group is full:
+    later candidates are not even probed. Use one group per bus for more sensors. Candidates are not
+    copied, so they must outlive the group.
+    @param candidates - an array of sensors, ie. one per address
+    @param count      - the number of candidates
+    @returns the number of sensors added, at most BusMaxSensors less "size()" beforehand
+*/
+uint8_t SDP3xBus::discover(SDP3x *candidates, uint8_t count) {
+    uint8_t found[BusMaxSensors];
+    uint8_t added = 0;
+    uint8_t next  = 0;
+    uint8_t n;
+    uint8_t i;
+    while ((next < count) && (this->count < BusMaxSensors)) {
+        // Probe only as many responders as there is room for, before the longer identification
+        for (n = 0; (next < count) && (n < BusMaxSensors - this->count); next++) {
+            if (candidates[next].probe()) {
+                found[n++] = next;
+            }
+        }
+        // Any that fail to identify leave room for the next batch
+        for (i = 0; i < n; i++) {
+            if (candidates[found[i]].begin() && add(&candidates[found[i]])) {
+                added++;
+            }
+        }
+    }
+    return added;
+}
+
+/*  Finish Initializing every sensor in this group
+
+    @returns true, iff every sensor was initialized correctly
+*/
+bool SDP3xBus::begin() {
+    bool success = true;
+    uint8_t i;
+    for (i = 0; i < this->count; i++) {
+        success = this->sensors[i]->begin() && success;
+    }
+    return success;
+}
+
+/*  Begin taking continuous readings on every sensor
+
+    @param averaging - average samples until read occurs, otherwise read last value only
+    @returns true, iff every sensor started correctly
+*/
+bool SDP3xBus::startContinuous(bool averaging) {
+    bool success = true;
+    uint8_t i;
+    for (i = 0; i < this->count; i++) {
+        success = this->sensors[i]->startContinuous(averaging) && success;
+    }
+    return success;
+}
+
+/*  Disable continuous measurements on every sensor
+
+    @returns true, iff every sensor stopped correctly
+*/
+bool SDP3xBus::stopContinuous() {
+    bool success = true;
+    uint8_t i;
+    for (i = 0; i < this->count; i++) {
+        success = this->sensors[i]->stopContinuous() && success;
+    }
+    return success;
+}
+
+/*  Start a one-shot reading on every sensor, back-to-back
+
+    Clock stretching is never used, so that one sensor cannot hold the bus while the others wait.
+    Use "isReady" to know when the readings may be collected.
+
+    SDP3x sensors only answer a general call for soft reset, so the triggers are sent as close
+    together as the bus allows, and the time of each is kept for "getTriggerTime".
+    @returns true, iff every trigger was sent successfully
+*/
+bool SDP3xBus::triggerAll() {
+    bool success = true;
+    uint8_t i;
+    for (i = 0; i < this->count; i++) {
+        success               = this->sensors[i]->triggerMeasurement(false) && success;
+        this->triggerTimes[i] = micros();
+    }
+    // The last sensor triggered is the last to settle
+    this->ready = micros() + TrigSettleTime * 1000UL;
+    this->armed = true;
+    return success;
+}
+
+/*  Get the time a sensor was triggered by the last "triggerAll"
+
+    @param index - the position of the sensor, in the order it was added
+    @returns the time in us, taken just after the trigger was acknowledged
+*/
+unsigned long SDP3xBus::getTriggerTime(uint8_t index) {
+    if (index >= this->count) {
+        return 0;
+    }
+    return this->triggerTimes[index];
+}
+
+/*  Get the spread of the trigger times from the last "triggerAll"
+
+    @returns the time in us between the first and last sensor being triggered
+*/
+unsigned long SDP3xBus::getTriggerSkew() {
+    if (this->count == 0) {
+        return 0;
+    }
+    return this->triggerTimes[this->count - 1] - this->triggerTimes[0];
+}
+
+/*  Check if the readings started by "triggerAll" are available
+
+    @returns true, iff "triggerAll" was called, the readings have not been collected by "readAll"
+             since, and TrigSettleTime ms have passed since the last trigger
+*/
+bool SDP3xBus::isReady() {
+    // Signed difference, so that micros() wrapping around is handled
+    return this->armed && ((long)(micros() - this->ready) >= 0);
+}
+
+/*  Read every sensor, back-to-back
+
+    Each array must hold at least "size()" values and is indexed like "get". Both "temp" and
+    "scale" should be left NULL if not used. This will reduce read times. Every sensor is read even
+    if an earlier one fails, and the slots of a sensor that fails are left untouched.
+    @param pressure - an array to store the raw pressure values
+    @param temp     - an array to store the raw temperature values
+    @param scale    - an array to store the pressure scaling factors
+    @returns true, iff every sensor was read correctly
+*/
+bool SDP3xBus::readAll(int16_t *pressure, int16_t *temp, int16_t *scale) {
+    bool success = true;
+    uint8_t i;
+    this->armed = false;
+    for (i = 0; i < this->count; i++) {
+        if (!this->sensors[i]->readMeasurement(pressure, temp, scale)) {
+            success = false;
+        }
+        // Advance each output to the next sensor's slot
+        if (pressure != NULL) {
+            pressure++;
+        }
+        if (temp != NULL) {
+            temp++;
+        }
+        if (scale != NULL) {
+            scale++;
+        }
+    }
+    return success;
+}
+
+/*  Trigger every sensor, wait for the readings, and read every sensor
+
+    @param pressure - an array to store the raw pressure values
+    @param temp     - an array to store the raw temperature values
+    @param scale    - an array to store the pressure scaling factors
+    @returns true, iff every sensor was triggered and read correctly
+*/
+bool SDP3xBus::measureAll(int16_t *pressure, int16_t *temp, int16_t *scale) {
+    bool success = triggerAll();
+    while (!isReady()) {
+        // wait for the slowest sensor to settle
+    }
+    return readAll(pressure, temp, scale) && success;
+}
@@ -0,0 +1,166 @@
+/*
+    SDP3xBus.h - Group scheduling for multiple SDP3x sensors on one I2C bus.
+
+    Copyright (c) 2018 Bryan T. Meyers
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+    and associated documentation files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+    BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SDP3X_BUS_H
+#define SDP3X_BUS_H
+
+#include "SDP3x.h"
+
+namespace SDP3X {
+    /* The maximum number of sensors in a single SDP3xBus (one per valid address) */
+    const uint8_t BusMaxSensors = 3;
+
+    /*  The SDP3xBus class groups several SDP3x sensors and pipelines their transactions
+
+        Rather than trigger-wait-read for each sensor in turn, every sensor is triggered
+        back-to-back, a single settle time is waited, and then every sensor is read back-to-back.
+    */
+    class SDP3xBus {
+    private:
+        /* The sensors in this group, in the order they were added */
+        SDP3x *sensors[BusMaxSensors];
+        /* The number of sensors in this group */
+        uint8_t count;
+        /* Time the readings of the last triggerAll are available, in us */
+        unsigned long ready;
+        /* True iff triggerAll was called and the readings have not been collected yet */
+        bool armed;
+        /* Time each sensor was triggered by the last triggerAll, in us */
+        unsigned long triggerTimes[BusMaxSensors];
+
+    public:
+        /*  Constructor
+
+            @returns a new, empty SDP3xBus
+        */
+        SDP3xBus();
+
+        /*  Add a sensor to this group
+
+            The sensor is not copied, so it must outlive the group.
+            @param sensor - the sensor to add
+            @returns true, iff there was room for the sensor
+        */
+        bool add(SDP3x *sensor);
+
+        /*  Get the number of sensors in this group
+
+            @returns the number of sensors added so far
+        */
+        uint8_t size();
+
+        /*  Get a sensor from this group
+
+            @param index - the position of the sensor, in the order it was added
+            @returns the sensor, or NULL if index is out of range
+        */
+        SDP3x *get(uint8_t index);
+
+        /*  Find which candidate sensors are present, and add them once initialized
+
+            Candidates are probed with an empty write, which only needs an ACK, so unpopulated
+            addresses cost a single address byte. Only the sensors that answered are then
+            identified with "begin". The group holds at most BusMaxSensors sensors in total, even
+            if the candidates are spread over several buses, so candidates are taken in order and
+            discovery stops once the group is full: later candidates are not even probed. Use one
+            group per bus for more sensors. Candidates are not copied, so they must outlive the
+            group.
+            @param candidates - an array of sensors, ie. one per address
+            @param count      - the number of candidates
+            @returns the number of sensors added, at most BusMaxSensors less "size()" beforehand
+        */
+        uint8_t discover(SDP3x *candidates, uint8_t count);
+
+        /*  Finish Initializing every sensor in this group
+
+            @returns true, iff every sensor was initialized correctly
+        */
+        bool begin();
+
+        /*  Begin taking continuous readings on every sensor
+
+            @param averaging - average samples until read occurs, otherwise read last value only
+            @returns true, iff every sensor started correctly
+        */
+        bool startContinuous(bool averaging);
+
+        /*  Disable continuous measurements on every sensor
+
+            @returns true, iff every sensor stopped correctly
+        */
+        bool stopContinuous();
+
+        /*  Start a one-shot reading on every sensor, back-to-back
+
+            Clock stretching is never used, so that one sensor cannot hold the bus while the
+            others wait. Use "isReady" to know when the readings may be collected.
+
+            SDP3x sensors only answer a general call for soft reset, so the triggers are sent as
+            close together as the bus allows, and the time of each is kept for "getTriggerTime".
+            @returns true, iff every trigger was sent successfully
+        */
+        bool triggerAll();
+
+        /*  Get the time a sensor was triggered by the last "triggerAll"
+
+            @param index - the position of the sensor, in the order it was added
+            @returns the time in us, taken just after the trigger was acknowledged
+        */
+        unsigned long getTriggerTime(uint8_t index);
+
+        /*  Get the spread of the trigger times from the last "triggerAll"
+
+            @returns the time in us between the first and last sensor being triggered
+        */
+        unsigned long getTriggerSkew();
+
+        /*  Check if the readings started by "triggerAll" are available
+
+            @returns true, iff "triggerAll" was called, the readings have not been collected by
+                     "readAll" since, and TrigSettleTime ms have passed since the last trigger
+        */
+        bool isReady();
+
+        /*  Read every sensor, back-to-back
+
+            Each array must hold at least "size()" values and is indexed like "get". Both "temp"
+            and "scale" should be left NULL if not used. This will reduce read times. Every sensor
+            is read even if an earlier one fails, and the slots of a sensor that fails are left
+            untouched.
+            @param pressure - an array to store the raw pressure values
+            @param temp     - an array to store the raw temperature values
+            @param scale    - an array to store the pressure scaling factors
+            @returns true, iff every sensor was read correctly
+        */
+        bool readAll(int16_t *pressure, int16_t *temp, int16_t *scale);
+
+        /*  Trigger every sensor, wait for the readings, and read every sensor
+
+            @param pressure - an array to store the raw pressure values
+            @param temp     - an array to store the raw temperature values
+            @param scale    - an array to store the pressure scaling factors
+            @returns true, iff every sensor was triggered and read correctly
+        */
+        bool measureAll(int16_t *pressure, int16_t *temp, int16_t *scale);
+    };
+} // namespace SDP3X
+
+#endif
@@ -0,0 +1,147 @@
+/*
+    SDP3xCalibration.cpp - Zero offset calibration for SDP3x sensors.
+
+    Copyright (c) 2018 Bryan T. Meyers
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+    and associated documentation files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+    BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "SDP3xCalibration.h"
+
+using namespace SDP3X;
+
+/*  Divide, rounding to the nearest integer
+
+    @param num - the numerator
+    @param den - the denominator, which must be positive
+    @returns num / den, rounded half away from zero
+*/
+static int64_t divRound(int64_t num, int64_t den) {
+    return (num < 0) ? -((-num + den / 2) / den) : ((num + den / 2) / den);
+}
+
+/*  Limit a slope to what SDP3xCalibration can hold
+
+    @param slope - the slope, with CalibrationSlopeShift fraction bits
+    @returns the slope, saturated to 16 bits
+*/
+static int16_t clampSlope(int64_t slope) {
+    if (slope > 32767) {
+        return 32767;
+    }
+    if (slope < -32768) {
+        return -32768;
+    }
+    return (int16_t)slope;
+}
+
+/*  Measure the zero offset of a sensor
+
+    The sensor must be at zero flow/pressure difference. A burst of continuous readings is averaged
+    in integer math, and if "withTemp" is set, the mean temperature is kept as refTemp. The slope is
+    only fitted by least squares if the temperature has a standard deviation of at least
+    CalibrationMinSpread over the burst, and is 0 otherwise, since a fit over a near constant
+    temperature is only noise. A burst rarely spans that much, so use "calibrateTwoPoint" with
+    offsets taken at two temperatures instead. Continuous mode is stopped afterwards.
+    @param sensor   - the sensor to calibrate
+    @param samples  - the number of readings to average
+    @param withTemp - also fit the temperature dependence of the offset
+    @param cal      - a pointer to store the calibration
+    @returns true, iff everything went correctly
+*/
+bool SDP3X::calibrateZero(SDP3x &sensor, uint16_t samples, bool withTemp, SDP3xCalibration *cal) {
+    int16_t pressure[CalibrationBlock];
+    int16_t temp[CalibrationBlock];
+    int32_t sumP  = 0;
+    int32_t sumT  = 0;
+    int64_t sumTT = 0;
+    int64_t sumTP = 0;
+    int64_t cov;
+    int64_t var;
+    uint16_t done = 0;
+    uint8_t n;
+    uint8_t i;
+    if (samples == 0) {
+        return false;
+    }
+    // The sensor may have been left running, and must be stopped before it is restarted
+    sensor.stopContinuous();
+    delay(ContStopTime);
+    if (!sensor.startContinuous(false)) {
+        return false;
+    }
+    delay(ContStartTime);
+    while (done < samples) {
+        n = ((samples - done) < CalibrationBlock) ? (samples - done) : CalibrationBlock;
+        if (sensor.readMeasurements(pressure, withTemp ? temp : NULL, n, ContUpdateTime * 1000U) !=
+            n) {
+            sensor.stopContinuous();
+            return false;
+        }
+        for (i = 0; i < n; i++) {
+            sumP += pressure[i];
+            if (withTemp) {
+                sumT += temp[i];
+                sumTT += (int32_t)temp[i] * temp[i];
+                sumTP += (int32_t)temp[i] * pressure[i];
+            }
+        }
+        done += n;
+    }
+    sensor.stopContinuous();
+
+    cal->offset  = (int16_t)divRound(sumP, samples);
+    cal->slope   = 0;
+    cal->refTemp = 0;
+    if (withTemp) {
+        cal->refTemp = (int16_t)divRound(sumT, samples);
+        // Least-squares slope, scaled by N^2 top and bottom to stay in integers
+        var = sumTT * samples - (int64_t)sumT * sumT;
+        cov = sumTP * samples - (int64_t)sumT * sumP;
+        // The variance is scaled by N^2 as well, so the threshold is too
+        if (var >= (int64_t)CalibrationMinSpread * CalibrationMinSpread * samples * samples) {
+            cal->slope = clampSlope(divRound(cov * (1 << CalibrationSlopeShift), var));
+        }
+    }
+    return true;
+}
+
+/*  Find the temperature dependence of the offset from two calibrations
+
+    Each calibration should come from "calibrateZero" with "withTemp" set, at temperatures at least
+    CalibrationMinSpread apart. The result keeps the offset and refTemp of "first".
+    @param first  - the calibration at one temperature
+    @param second - the calibration at another temperature
+    @param cal    - a pointer to store the calibration, which may be "first" or "second"
+    @returns true, iff the temperatures were far enough apart
+*/
+bool SDP3X::calibrateTwoPoint(const SDP3xCalibration &first, const SDP3xCalibration &second,
+                              SDP3xCalibration *cal) {
+    int32_t dt = (int32_t)second.refTemp - first.refTemp;
+    int32_t dp = (int32_t)second.offset - first.offset;
+    if ((dt < CalibrationMinSpread) && (dt > -(int32_t)CalibrationMinSpread)) {
+        return false;
+    }
+    if (dt < 0) {
+        dt = -dt;
+        dp = -dp;
+    }
+    // Both are read before "cal" is written, in case it aliases either
+    cal->slope   = clampSlope(divRound((int64_t)dp * (1 << CalibrationSlopeShift), dt));
+    cal->offset  = first.offset;
+    cal->refTemp = first.refTemp;
+    return true;
+}
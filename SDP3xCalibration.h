@@ -0,0 +1,128 @@
+/*
+    SDP3xCalibration.h - Zero offset calibration for SDP3x sensors.
+
+    Copyright (c) 2018 Bryan T. Meyers
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+    and associated documentation files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+    BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SDP3X_CALIBRATION_H
+#define SDP3X_CALIBRATION_H
+
+#include "SDP3x.h"
+#include "SDP3xConvert.h"
+
+namespace SDP3X {
+    /* The number of samples read per block during calibration */
+    const uint8_t CalibrationBlock = 16;
+    /* Fractional bits of SDP3xCalibration::slope */
+    const uint8_t CalibrationSlopeShift = 8;
+    /* Least temperature spread for a slope, in raw counts (1C) */
+    const uint16_t CalibrationMinSpread = 200;
+
+    /*  SDP3xCalibration holds the zero offset of a sensor, in raw counts
+
+        The offset at temperature T is offset + slope * (T - refTemp) / 2^CalibrationSlopeShift.
+        Without temperature compensation, slope is 0 and correction is a single subtraction.
+    */
+    struct SDP3xCalibration {
+        /* Raw pressure reading at zero flow, at refTemp */
+        int16_t offset;
+        /* Change in offset per raw temperature count, with CalibrationSlopeShift fraction bits */
+        int16_t slope;
+        /* Raw temperature at which offset was measured */
+        int16_t refTemp;
+    };
+
+    /*  Measure the zero offset of a sensor
+
+        The sensor must be at zero flow/pressure difference. A burst of continuous readings is
+        averaged in integer math, and if "withTemp" is set, the mean temperature is kept as
+        refTemp. The slope is only fitted by least squares if the temperature has a standard
+        deviation of at least CalibrationMinSpread over the burst, and is 0 otherwise, since a
+        fit over a near constant temperature is only noise. A burst rarely spans that much, so
+        use "calibrateTwoPoint" with offsets taken at two temperatures instead. Continuous mode
+        is stopped afterwards.
+        @param sensor   - the sensor to calibrate
+        @param samples  - the number of readings to average
+        @param withTemp - also fit the temperature dependence of the offset
+        @param cal      - a pointer to store the calibration
+        @returns true, iff everything went correctly
+    */
+    bool calibrateZero(SDP3x &sensor, uint16_t samples, bool withTemp, SDP3xCalibration *cal);
+
+    /*  Find the temperature dependence of the offset from two calibrations
+
+        Each calibration should come from "calibrateZero" with "withTemp" set, at temperatures at
+        least CalibrationMinSpread apart. The result keeps the offset and refTemp of "first".
+        @param first  - the calibration at one temperature
+        @param second - the calibration at another temperature
+        @param cal    - a pointer to store the calibration, which may be "first" or "second"
+        @returns true, iff the temperatures were far enough apart
+    */
+    bool calibrateTwoPoint(const SDP3xCalibration &first, const SDP3xCalibration &second,
+                           SDP3xCalibration *cal);
+
+    /*  Remove the zero offset from a raw pressure value
+
+        @param cal      - the calibration of the sensor
+        @param pressure - the raw pressure value
+        @returns the corrected raw pressure value
+    */
+    inline int16_t applyCalibration(const SDP3xCalibration &cal, int16_t pressure) {
+        return pressure - cal.offset;
+    }
+
+    /*  Remove the temperature dependent zero offset from a raw pressure value
+
+        @param cal      - the calibration of the sensor
+        @param pressure - the raw pressure value
+        @param temp     - the raw temperature value
+        @returns the corrected raw pressure value
+    */
+    inline int16_t applyCalibration(const SDP3xCalibration &cal, int16_t pressure, int16_t temp) {
+        int32_t drift = ((int32_t)cal.slope * (temp - cal.refTemp)) >> CalibrationSlopeShift;
+        return (int16_t)(pressure - cal.offset - drift);
+    }
+
+    /*  Convert a raw pressure value, removing the zero offset first
+
+        This is "toMilliPascal" with the single subtraction of "applyCalibration" in front, so
+        no separate correction step is needed.
+        @param raw   - the raw pressure value
+        @param scale - the pressure scale, as returned by getPressureScale
+        @param cal   - the calibration of the sensor
+        @returns the corrected pressure in mPa
+    */
+    inline int32_t toMilliPascal(int16_t raw, uint8_t scale, const SDP3xCalibration &cal) {
+        return toMilliPascal(applyCalibration(cal, raw), scale);
+    }
+
+    /*  Convert a raw pressure value, removing the temperature dependent zero offset first
+
+        @param raw   - the raw pressure value
+        @param temp  - the raw temperature value
+        @param scale - the pressure scale, as returned by getPressureScale
+        @param cal   - the calibration of the sensor
+        @returns the corrected pressure in mPa
+    */
+    inline int32_t toMilliPascal(int16_t raw, int16_t temp, uint8_t scale,
+                                 const SDP3xCalibration &cal) {
+        return toMilliPascal(applyCalibration(cal, raw, temp), scale);
+    }
+} // namespace SDP3X
+
+#endif
@@ -0,0 +1,88 @@
+/*
+    SDP3xChange.cpp - Deadband change detection on raw SDP3x pressure values.
+
+    Copyright (c) 2018 Bryan T. Meyers
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+    and associated documentation files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+    BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "SDP3xChange.h"
+
+using namespace SDP3X;
+
+/*  Constructor
+
+    @param deadband  - the largest change in raw counts that is suppressed
+    @param heartbeat - time in ms after which a reading is always emitted, 0 to disable
+    @returns a new SDP3xChangeDetector, which emits the first reading it sees
+*/
+SDP3xChangeDetector::SDP3xChangeDetector(uint16_t deadband, unsigned long heartbeat) {
+    this->last      = 0;
+    this->lastTime  = 0;
+    this->deadband  = deadband;
+    this->heartbeat = heartbeat;
+    this->primed    = false;
+}
+
+/*  Check whether a reading should be emitted
+
+    @param pressure - the raw pressure value
+    @returns true, iff the reading changed by more than the deadband or the heartbeat passed
+*/
+bool SDP3xChangeDetector::update(int16_t pressure) {
+    unsigned long now = millis();
+    int32_t change    = (int32_t)pressure - this->last;
+    if (change < 0) {
+        change = -change;
+    }
+    if (this->primed && (change <= this->deadband) &&
+        ((this->heartbeat == 0) || ((now - this->lastTime) < this->heartbeat))) {
+        return false;
+    }
+    this->last     = pressure;
+    this->lastTime = now;
+    this->primed   = true;
+    return true;
+}
+
+/*  Read a sensor, emitting only changed readings
+
+    @param sensor   - the sensor to read
+    @param pressure - a pointer to store the raw pressure value, only written when emitted
+    @returns true, iff the read succeeded and the reading was emitted
+*/
+bool SDP3xChangeDetector::read(SDP3x &sensor, int16_t *pressure) {
+    int16_t value;
+    if (!sensor.readMeasurement(&value, NULL, NULL) || !update(value)) {
+        return false;
+    }
+    *pressure = value;
+    return true;
+}
+
+/*  Get the last emitted reading
+
+    @returns the raw pressure value
+*/
+int16_t SDP3xChangeDetector::getLast() {
+    return this->last;
+}
+
+/*  Forget the last emitted reading, so that the next one is always emitted
+ */
+void SDP3xChangeDetector::reset() {
+    this->primed = false;
+}
@@ -0,0 +1,83 @@
+/*
+    SDP3xChange.h - Deadband change detection on raw SDP3x pressure values.
+
+    Copyright (c) 2018 Bryan T. Meyers
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+    and associated documentation files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+    BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SDP3X_CHANGE_H
+#define SDP3X_CHANGE_H
+
+#include "SDP3x.h"
+
+namespace SDP3X {
+    /*  The SDP3xChangeDetector class suppresses readings that have not meaningfully changed
+
+        A reading is emitted when it differs from the last emitted reading by more than a deadband
+        of raw counts, or when a heartbeat timeout has passed since the last emitted reading, so
+        that consumers still know the sensor is alive under steady flow.
+    */
+    class SDP3xChangeDetector {
+    private:
+        /* The last emitted raw pressure value */
+        int16_t last;
+        /* Time of the last emitted reading in ms */
+        unsigned long lastTime;
+        /* The largest change in raw counts that is suppressed */
+        uint16_t deadband;
+        /* Time in ms after which a reading is always emitted, 0 to disable */
+        unsigned long heartbeat;
+        /* True iff a reading has been emitted */
+        bool primed;
+
+    public:
+        /*  Constructor
+
+            @param deadband  - the largest change in raw counts that is suppressed
+            @param heartbeat - time in ms after which a reading is always emitted, 0 to disable
+            @returns a new SDP3xChangeDetector, which emits the first reading it sees
+        */
+        SDP3xChangeDetector(uint16_t deadband, unsigned long heartbeat);
+
+        /*  Check whether a reading should be emitted
+
+            @param pressure - the raw pressure value
+            @returns true, iff the reading changed by more than the deadband or the heartbeat passed
+        */
+        bool update(int16_t pressure);
+
+        /*  Read a sensor, emitting only changed readings
+
+            @param sensor   - the sensor to read
+            @param pressure - a pointer to store the raw pressure value, only written when emitted
+            @returns true, iff the read succeeded and the reading was emitted
+        */
+        bool read(SDP3x &sensor, int16_t *pressure);
+
+        /*  Get the last emitted reading
+
+            @returns the raw pressure value
+        */
+        int16_t getLast();
+
+        /*  Forget the last emitted reading, so that the next one is always emitted
+         */
+        void reset();
+    };
+} // namespace SDP3X
+
+#endif
@@ -0,0 +1,114 @@
+/*
+    SDP3xConvert.h - Fast engineering unit conversions for raw SDP3x values.
+
+    Copyright (c) 2018 Bryan T. Meyers
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+    and associated documentation files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+    BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SDP3X_CONVERT_H
+#define SDP3X_CONVERT_H
+
+#include "SDP3x.h"
+
+namespace SDP3X {
+    /*  Reciprocal Multiply-Shift Constants
+
+        mPa = (raw * Mul + 2^(Shift - 1)) >> Shift, which replaces a division by the scale.
+        Mul is kept below 2^16 so that the product of a raw value always fits in an int32_t, and
+        the error stays under half of one raw count across the whole range.
+    */
+    const uint16_t SDP31_MilliPascalMul    = 34133; // 1000 / 60 * 2^11
+    const uint8_t SDP31_MilliPascalShift   = 11;
+    const uint16_t SDP32_MilliPascalMul    = 34133; // 1000 / 240 * 2^13
+    const uint8_t SDP32_MilliPascalShift   = 13;
+    const uint8_t SDP3X_MilliCelsiusPerLSB = 1000 / SDP3X_TempScale;
+
+    /*  Convert a raw SDP31 pressure value
+
+        @param raw - the raw pressure value
+        @returns the pressure in mPa
+    */
+    inline int32_t toMilliPascalSDP31(int16_t raw) {
+        return ((int32_t)raw * SDP31_MilliPascalMul + (1L << (SDP31_MilliPascalShift - 1))) >>
+               SDP31_MilliPascalShift;
+    }
+
+    /*  Convert a raw SDP32 pressure value
+
+        @param raw - the raw pressure value
+        @returns the pressure in mPa
+    */
+    inline int32_t toMilliPascalSDP32(int16_t raw) {
+        return ((int32_t)raw * SDP32_MilliPascalMul + (1L << (SDP32_MilliPascalShift - 1))) >>
+               SDP32_MilliPascalShift;
+    }
+
+    /*  Convert a raw pressure value
+
+        @param raw   - the raw pressure value
+        @param scale - the pressure scale, as returned by getPressureScale
+        @returns the pressure in mPa
+    */
+    inline int32_t toMilliPascal(int16_t raw, uint8_t scale) {
+        switch (scale) {
+        case SDP31_DiffScale:
+            return toMilliPascalSDP31(raw);
+        case SDP32_DiffScale:
+            return toMilliPascalSDP32(raw);
+        default:
+            return ((int32_t)raw * 1000) / scale;
+        }
+    }
+
+    /*  Convert a raw temperature value
+
+        This is exact, since the temperature scale divides 1000.
+        @param raw - the raw temperature value
+        @returns the temperature in mC
+    */
+    inline int32_t toMilliCelsius(int16_t raw) {
+        return (int32_t)raw * SDP3X_MilliCelsiusPerLSB;
+    }
+
+    /*  Convert a raw pressure value using a precomputed reciprocal
+
+        @param raw   - the raw pressure value
+        @param scale - the pressure scale, as returned by getPressureScale
+        @returns the pressure in Pa
+    */
+    inline float toPascal(int16_t raw, uint8_t scale) {
+        switch (scale) {
+        case SDP31_DiffScale:
+            return raw * (1.0f / SDP31_DiffScale);
+        case SDP32_DiffScale:
+            return raw * (1.0f / SDP32_DiffScale);
+        default:
+            return raw / (float)scale;
+        }
+    }
+
+    /*  Convert a raw temperature value using a precomputed reciprocal
+
+        @param raw - the raw temperature value
+        @returns the temperature in C
+    */
+    inline float toCelsius(int16_t raw) {
+        return raw * (1.0f / SDP3X_TempScale);
+    }
+} // namespace SDP3X
+
+#endif
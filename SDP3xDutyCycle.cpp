@@ -0,0 +1,119 @@
+/*
+    SDP3xDutyCycle.cpp - Low-power duty-cycled acquisition for SDP3x sensors.
+
+    Copyright (c) 2018 Bryan T. Meyers
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+    and associated documentation files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+    BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "SDP3xDutyCycle.h"
+
+using namespace SDP3X;
+
+/*  Constructor
+
+    @param sensor   - the sensor to sample, which must outlive this object
+    @param periodMs - the time between readings in ms
+    @returns a new, stopped SDP3xDutyCycle
+*/
+SDP3xDutyCycle::SDP3xDutyCycle(SDP3x &sensor, unsigned long periodMs) : schedule(sensor) {
+    this->period    = periodMs * 1000UL;
+    this->next      = 0;
+    this->running   = false;
+    this->measuring = false;
+}
+
+/*  Begin duty-cycled acquisition
+
+    Continuous mode is stopped first, in case the sensor was left running, and the first trigger
+    waits for the sensor to finish stopping.
+    @returns true, iff everything went correctly
+*/
+bool SDP3xDutyCycle::start() {
+    bool success    = this->schedule.stopContinuous();
+    this->next      = micros() + ContStopTime * 1000UL;
+    this->running   = true;
+    this->measuring = false;
+    return success;
+}
+
+/*  End duty-cycled acquisition, leaving the sensor idle
+ */
+void SDP3xDutyCycle::stop() {
+    this->running   = false;
+    this->measuring = false;
+}
+
+/*  Trigger or read the sensor, as needed
+
+    Call this from loop() and after every wake from sleep.
+    @param pressure - a pointer to store the raw pressure value
+    @param temp     - if not null, a pointer to store the raw temperature value
+    @returns true, iff a new reading was stored
+*/
+bool SDP3xDutyCycle::update(int16_t *pressure, int16_t *temp) {
+    unsigned long now;
+    if (!this->running) {
+        return false;
+    }
+    if (this->measuring) {
+        if (!this->schedule.isReady()) {
+            return false;
+        }
+        // Whatever the result, this reading is finished and the sensor is idle again
+        this->measuring = false;
+        return this->schedule.read(pressure, temp, NULL);
+    }
+    now = micros();
+    if ((long)(now - this->next) < 0) {
+        return false;
+    }
+    // Keep to the period, unless so far behind that readings would bunch up
+    this->next += this->period;
+    if ((long)(now - this->next) >= 0) {
+        this->next = now + this->period;
+    }
+    this->measuring = this->schedule.trigger();
+    return false;
+}
+
+/*  Get how long the MCU may sleep before "update" has work to do
+
+    @returns the time in us, 0 if "update" should be called now
+*/
+unsigned long SDP3xDutyCycle::sleepTime() {
+    long left;
+    if (!this->running) {
+        return 0;
+    }
+    if (this->measuring) {
+        return this->schedule.timeUntilReady();
+    }
+    left = (long)(this->next - micros());
+    return (left > 0) ? (unsigned long)left : 0;
+}
+
+/*  Account for time that passed without micros() advancing
+
+    Call this after waking from a sleep that stops micros() (ie. AVR power-down with the watchdog
+    as wake source), before "update", with the time actually slept.
+    @param us - the time slept in us
+*/
+void SDP3xDutyCycle::addSleptTime(unsigned long us) {
+    // Both the next trigger and any pending reading are now that much closer
+    this->next -= us;
+    this->schedule.addSleptTime(us);
+}
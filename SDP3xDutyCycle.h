@@ -0,0 +1,96 @@
+/*
+    SDP3xDutyCycle.h - Low-power duty-cycled acquisition for SDP3x sensors.
+
+    Copyright (c) 2018 Bryan T. Meyers
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+    and associated documentation files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+    BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SDP3X_DUTY_CYCLE_H
+#define SDP3X_DUTY_CYCLE_H
+
+#include "SDP3xScheduler.h"
+
+namespace SDP3X {
+    /*  The SDP3xDutyCycle class takes one-shot readings at a fixed period
+
+        The sensor idles between readings, which is its lowest power state, and "sleepTime"
+        reports how long the MCU may sleep before "update" has work to do. Since a one-shot reading
+        takes TrigSettleTime, the period should be at least that long.
+
+        Timing uses micros(), which stops during AVR power-down sleep. After such a sleep, credit
+        the time slept with "addSleptTime", or the period will stretch by the time spent asleep.
+    */
+    class SDP3xDutyCycle {
+    private:
+        /* Tracks when the triggered reading is ready */
+        SDP3xScheduler schedule;
+        /* Time between readings in us */
+        unsigned long period;
+        /* Time in us at which the next reading should be triggered */
+        unsigned long next;
+        /* True iff acquisition has been started */
+        bool running;
+        /* True iff a reading has been triggered but not yet read */
+        bool measuring;
+
+    public:
+        /*  Constructor
+
+            @param sensor   - the sensor to sample, which must outlive this object
+            @param periodMs - the time between readings in ms
+            @returns a new, stopped SDP3xDutyCycle
+        */
+        SDP3xDutyCycle(SDP3x &sensor, unsigned long periodMs);
+
+        /*  Begin duty-cycled acquisition
+
+            Continuous mode is stopped first, in case the sensor was left running, and the first
+            trigger waits for the sensor to finish stopping.
+            @returns true, iff everything went correctly
+        */
+        bool start();
+
+        /*  End duty-cycled acquisition, leaving the sensor idle
+         */
+        void stop();
+
+        /*  Trigger or read the sensor, as needed
+
+            Call this from loop() and after every wake from sleep.
+            @param pressure - a pointer to store the raw pressure value
+            @param temp     - if not null, a pointer to store the raw temperature value
+            @returns true, iff a new reading was stored
+        */
+        bool update(int16_t *pressure, int16_t *temp);
+
+        /*  Get how long the MCU may sleep before "update" has work to do
+
+            @returns the time in us, 0 if "update" should be called now
+        */
+        unsigned long sleepTime();
+
+        /*  Account for time that passed without micros() advancing
+
+            Call this after waking from a sleep that stops micros() (ie. AVR power-down with the
+            watchdog as wake source), before "update", with the time actually slept.
+            @param us - the time slept in us
+        */
+        void addSleptTime(unsigned long us);
+    };
+} // namespace SDP3X
+
+#endif
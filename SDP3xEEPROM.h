@@ -0,0 +1,246 @@
+/*
+    SDP3xEEPROM.h - Persist SDP3x identification in EEPROM for fast warm starts.
+
+    Copyright (c) 2018 Bryan T. Meyers
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+    and associated documentation files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+    BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SDP3X_EEPROM_H
+#define SDP3X_EEPROM_H
+
+#include "SDP3x.h"
+#include "SDP3xCalibration.h"
+
+#include <EEPROM.h>
+
+namespace SDP3X {
+    /*  EEPROM Layout
+
+        Starting at a caller-chosen base, there is one EEPROMSlotSize slot per sensor, for each
+        valid address on each bus: bus 0 Address1 is at base, bus 0 Address2 at base +
+        EEPROMSlotSize, and bus 1 Address1 at base + 3 * EEPROMSlotSize. The bus index is chosen
+        by the caller (ie. 0 for Wire, 1 for Wire1).
+
+        Each slot starts with the model record: EEPROMTag in the upper nibble and the Model in the
+        lower nibble, the serial number (most significant byte first), then a CRC-8 of the
+        previous bytes, so that blank (0xFF) or foreign bytes are rejected. The calibration record
+        follows at EEPROMModelSize: EEPROMTag, offset, slope and refTemp (most significant byte
+        first), then a CRC-8 of the previous bytes.
+    */
+    const uint8_t EEPROMTag             = 0xA0;
+    const uint8_t EEPROMTagMask         = 0xF0;
+    const uint8_t EEPROMModelSize       = 10;
+    const uint8_t EEPROMCalibrationSize = 8;
+    const uint8_t EEPROMSlotSize        = EEPROMModelSize + EEPROMCalibrationSize;
+
+    /*  Find the slot of a sensor
+
+        @param addr - the Address value for I2C
+        @param bus  - the index of the bus the sensor is on
+        @param base - the first EEPROM byte used by this library
+        @returns the first EEPROM byte of the slot, -1 if the address has none
+    */
+    inline int findSlot(uint8_t addr, uint8_t bus, int base) {
+        if ((addr < Address1) || (addr > Address3)) {
+            return -1;
+        }
+        return base + ((int)bus * 3 + (addr - Address1)) * EEPROMSlotSize;
+    }
+
+    /*  Read a record, checking its CRC-8
+
+        @param slot   - the first EEPROM byte of the record
+        @param record - an array to store the record
+        @param size   - the record size, including its CRC-8
+        @returns true, iff the record starts with EEPROMTag and its CRC-8 matches
+    */
+    inline bool readRecord(int slot, uint8_t *record, uint8_t size) {
+        uint8_t crc = 0xFF;
+        uint8_t i;
+        for (i = 0; i < size; i++) {
+            record[i] = EEPROM.read(slot + i);
+        }
+        for (i = 0; i < size - 1; i++) {
+            crc = crc8(crc, record[i]);
+        }
+        return ((record[0] & EEPROMTagMask) == EEPROMTag) && (record[size - 1] == crc);
+    }
+
+    /*  Write a record, adding its CRC-8
+
+        Only the bytes that differ are written, to spare EEPROM wear.
+        @param slot   - the first EEPROM byte of the record
+        @param record - the record, with room for the CRC-8 as its last byte
+        @param size   - the record size, including its CRC-8
+    */
+    inline void writeRecord(int slot, uint8_t *record, uint8_t size) {
+        uint8_t crc = 0xFF;
+        uint8_t i;
+        for (i = 0; i < size - 1; i++) {
+            crc = crc8(crc, record[i]);
+        }
+        record[size - 1] = crc;
+        for (i = 0; i < size; i++) {
+            if (EEPROM.read(slot + i) != record[i]) {
+                EEPROM.write(slot + i, record[i]);
+            }
+        }
+    }
+
+    /*  Load the model and serial number stored for a sensor
+
+        @param addr   - the Address value for I2C
+        @param bus    - the index of the bus the sensor is on
+        @param base   - the first EEPROM byte used by this library
+        @param model  - a pointer to store the model
+        @param serial - if not null, a pointer to store the serial number
+        @returns true, iff a valid model was stored for this sensor
+    */
+    inline bool loadModel(uint8_t addr, uint8_t bus, int base, Model *model, uint64_t *serial) {
+        uint8_t record[EEPROMModelSize];
+        int slot = findSlot(addr, bus, base);
+        uint8_t i;
+        if ((slot < 0) || !readRecord(slot, record, EEPROMModelSize) ||
+            ((record[0] & ~EEPROMTagMask) > SDP32)) {
+            return false;
+        }
+        *model = (Model)(record[0] & ~EEPROMTagMask);
+        if (serial != NULL) {
+            *serial = 0;
+            for (i = 1; i < 9; i++) {
+                *serial = (*serial << 8) | record[i];
+            }
+        }
+        return true;
+    }
+
+    /*  Store the model and serial number of a sensor
+
+        Some cores (ie. ESP32) also need EEPROM.begin() before and EEPROM.commit() after.
+        @param addr   - the Address value for I2C
+        @param bus    - the index of the bus the sensor is on
+        @param model  - the model to store
+        @param serial - the serial number to store
+        @param base   - the first EEPROM byte used by this library
+        @returns true, iff the address has a slot
+    */
+    inline bool storeModel(uint8_t addr, uint8_t bus, Model model, uint64_t serial, int base) {
+        uint8_t record[EEPROMModelSize];
+        int slot = findSlot(addr, bus, base);
+        uint8_t i;
+        if (slot < 0) {
+            return false;
+        }
+        record[0] = EEPROMTag | (uint8_t)model;
+        for (i = 8; i > 0; i--) {
+            record[i] = (uint8_t)serial;
+            serial >>= 8;
+        }
+        writeRecord(slot, record, EEPROMModelSize);
+        return true;
+    }
+
+    /*  Finish Initializing a sensor, skipping identification when its model is stored
+
+        On the first start the sensor is identified with "begin()", and its model and serial number
+        are stored. With "verify", a later start reads the product ID and serial number in one
+        transaction and only trusts the stored model if both match, so a sensor swapped for the
+        other model is identified again. Without it, a later start makes no I2C communication at
+        all, so only use that where the sensor cannot change (ie. waking from deep sleep).
+        @param sensor - the sensor to initialize
+        @param base   - the first EEPROM byte used by this library
+        @param bus    - the index of the bus the sensor is on (ie. 0 for Wire, 1 for Wire1)
+        @param verify - check the serial number of the sensor against the stored one
+        @returns true, iff everything went correctly
+    */
+    inline bool warmBegin(SDP3x &sensor, int base, uint8_t bus = 0, bool verify = true) {
+        Model model;
+        uint64_t stored;
+        uint64_t serial;
+        uint32_t pid;
+        if (loadModel(sensor.getAddress(), bus, base, &model, &stored)) {
+            if (!sensor.begin(model)) {
+                return false;
+            }
+            if (!verify) {
+                return true;
+            }
+            if (!sensor.readProductID(&pid, &serial)) {
+                return false;
+            }
+            if ((pid == ((model == SDP31) ? SDP31_PID : SDP32_PID)) && (serial == stored)) {
+                return true;
+            }
+        }
+        // Not stored, or a different sensor now, so identify it and store what it is
+        if (!sensor.begin() || !sensor.readProductID(&pid, &serial)) {
+            return false;
+        }
+        storeModel(sensor.getAddress(), bus, sensor.getModel(), serial, base);
+        return true;
+    }
+
+    /*  Load the calibration stored for a sensor
+
+        @param addr - the Address value for I2C
+        @param bus  - the index of the bus the sensor is on
+        @param base - the first EEPROM byte used by this library
+        @param cal  - a pointer to store the calibration
+        @returns true, iff a valid calibration was stored for this sensor
+    */
+    inline bool loadCalibration(uint8_t addr, uint8_t bus, int base, SDP3xCalibration *cal) {
+        uint8_t record[EEPROMCalibrationSize];
+        int slot = findSlot(addr, bus, base);
+        if ((slot < 0) || !readRecord(slot + EEPROMModelSize, record, EEPROMCalibrationSize) ||
+            (record[0] != EEPROMTag)) {
+            return false;
+        }
+        cal->offset  = (int16_t)(((uint16_t)record[1] << 8) | record[2]);
+        cal->slope   = (int16_t)(((uint16_t)record[3] << 8) | record[4]);
+        cal->refTemp = (int16_t)(((uint16_t)record[5] << 8) | record[6]);
+        return true;
+    }
+
+    /*  Store the calibration for a sensor
+
+        Some cores (ie. ESP32) also need EEPROM.begin() before and EEPROM.commit() after.
+        @param addr - the Address value for I2C
+        @param bus  - the index of the bus the sensor is on
+        @param cal  - the calibration to store
+        @param base - the first EEPROM byte used by this library
+        @returns true, iff the address has a slot
+    */
+    inline bool storeCalibration(uint8_t addr, uint8_t bus, const SDP3xCalibration &cal,
+                                 int base) {
+        uint8_t record[EEPROMCalibrationSize];
+        int slot = findSlot(addr, bus, base);
+        if (slot < 0) {
+            return false;
+        }
+        record[0] = EEPROMTag;
+        record[1] = (uint16_t)cal.offset >> 8;
+        record[2] = (uint16_t)cal.offset & 0xFF;
+        record[3] = (uint16_t)cal.slope >> 8;
+        record[4] = (uint16_t)cal.slope & 0xFF;
+        record[5] = (uint16_t)cal.refTemp >> 8;
+        record[6] = (uint16_t)cal.refTemp & 0xFF;
+        writeRecord(slot + EEPROMModelSize, record, EEPROMCalibrationSize);
+        return true;
+    }
+} // namespace SDP3X
+
+#endif
@@ -0,0 +1,325 @@
+/*
+    SDP3xFilter.h - Integer-only streaming filters for raw SDP3x values.
+
+    Copyright (c) 2018 Bryan T. Meyers
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+    and associated documentation files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+    BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SDP3X_FILTER_H
+#define SDP3X_FILTER_H
+
+#include "SDP3x.h"
+
+namespace SDP3X {
+    /*  Get the base 2 logarithm of a power of two
+
+        @param value - a power of two
+        @returns log2(value)
+    */
+    constexpr uint8_t ilog2(uint32_t value) {
+        return (value <= 1) ? 0 : 1 + ilog2(value >> 1);
+    }
+
+    /*  SDP3xIIR is a first-order low-pass filter: y += (x - y) / 2^Shift
+
+        The state keeps Shift extra bits of precision so that small steps are not lost.
+
+        @param Shift - the smoothing factor, larger is smoother (1 - 15)
+    */
+    template <uint8_t Shift> class SDP3xIIR {
+        static_assert((Shift >= 1) && (Shift <= 15), "SDP3xIIR shift must be 1 - 15");
+
+    private:
+        /* The filtered value, scaled by 2^Shift */
+        int32_t state;
+        /* Set once the first value has been seen */
+        bool primed;
+
+    public:
+        /*  Constructor
+
+            @returns a new SDP3xIIR, primed by the first value
+        */
+        SDP3xIIR() {
+            this->primed = false;
+        }
+
+        /*  Filter the next value
+
+            @param value - the next raw value
+            @returns the filtered value
+        */
+        int16_t update(int16_t value) {
+            if (!this->primed) {
+                this->state  = (int32_t)value << Shift;
+                this->primed = true;
+            }
+            this->state += value - (this->state >> Shift);
+            return (int16_t)(this->state >> Shift);
+        }
+
+        /*  Filter many values in place
+
+            @param values - the raw values, replaced by the filtered values
+            @param n      - the number of values
+        */
+        void filter(int16_t *values, uint8_t n) {
+            for (; n > 0; n--, values++) {
+                *values = update(*values);
+            }
+        }
+
+        /*  Forget all previous values
+         */
+        void reset() {
+            this->primed = false;
+        }
+    };
+
+    /*  SDP3xBoxcar is a moving average over the last N values
+
+        A power of two N turns the average into a shift.
+
+        @param N - the number of values to average (1 - 255)
+    */
+    template <uint8_t N> class SDP3xBoxcar {
+        static_assert(N >= 1, "SDP3xBoxcar length must be at least 1");
+
+    private:
+        /* The last N values */
+        int16_t window[N];
+        /* The sum of the window */
+        int32_t sum;
+        /* The position of the oldest value */
+        uint8_t next;
+        /* Set once the first value has been seen */
+        bool primed;
+
+    public:
+        /*  Constructor
+
+            @returns a new SDP3xBoxcar, primed by the first value
+        */
+        SDP3xBoxcar() {
+            this->primed = false;
+        }
+
+        /*  Filter the next value
+
+            @param value - the next raw value
+            @returns the average of the last N values
+        */
+        int16_t update(int16_t value) {
+            uint8_t i;
+            if (!this->primed) {
+                for (i = 0; i < N; i++) {
+                    this->window[i] = value;
+                }
+                this->sum    = (int32_t)value * N;
+                this->next   = 0;
+                this->primed = true;
+            }
+            this->sum += value - this->window[this->next];
+            this->window[this->next] = value;
+            if (++this->next == N) {
+                this->next = 0;
+            }
+            return (int16_t)(this->sum / N);
+        }
+
+        /*  Filter many values in place
+
+            @param values - the raw values, replaced by the filtered values
+            @param n      - the number of values
+        */
+        void filter(int16_t *values, uint8_t n) {
+            for (; n > 0; n--, values++) {
+                *values = update(*values);
+            }
+        }
+
+        /*  Forget all previous values
+         */
+        void reset() {
+            this->primed = false;
+        }
+    };
+
+    /*  SDP3xMedian is a median filter over the last N values, for rejecting single spikes
+
+        @param N - the number of values to consider (3 or 5)
+    */
+    template <uint8_t N> class SDP3xMedian {
+        static_assert((N == 3) || (N == 5), "SDP3xMedian length must be 3 or 5");
+
+    private:
+        /* The last N values */
+        int16_t window[N];
+        /* The position of the oldest value */
+        uint8_t next;
+        /* Set once the first value has been seen */
+        bool primed;
+
+    public:
+        /*  Constructor
+
+            @returns a new SDP3xMedian, primed by the first value
+        */
+        SDP3xMedian() {
+            this->primed = false;
+        }
+
+        /*  Filter the next value
+
+            @param value - the next raw value
+            @returns the median of the last N values
+        */
+        int16_t update(int16_t value) {
+            int16_t sorted[N];
+            int16_t v;
+            uint8_t i;
+            uint8_t j;
+            if (!this->primed) {
+                for (i = 0; i < N; i++) {
+                    this->window[i] = value;
+                }
+                this->next   = 0;
+                this->primed = true;
+            }
+            this->window[this->next] = value;
+            if (++this->next == N) {
+                this->next = 0;
+            }
+            // Insertion sort is the cheapest option for so few values
+            for (i = 0; i < N; i++) {
+                v = this->window[i];
+                for (j = i; (j > 0) && (sorted[j - 1] > v); j--) {
+                    sorted[j] = sorted[j - 1];
+                }
+                sorted[j] = v;
+            }
+            return sorted[N / 2];
+        }
+
+        /*  Filter many values in place
+
+            @param values - the raw values, replaced by the filtered values
+            @param n      - the number of values
+        */
+        void filter(int16_t *values, uint8_t n) {
+            for (; n > 0; n--, values++) {
+                *values = update(*values);
+            }
+        }
+
+        /*  Forget all previous values
+         */
+        void reset() {
+            this->primed = false;
+        }
+    };
+
+    /*  SDP3xCIC is a Cascaded Integrator-Comb decimator
+
+        One value comes out for every R values in, low-pass filtered and normalized back to the
+        raw range. Unsigned wrap-around arithmetic keeps the integrators exact without overflow
+        checks, as long as the R^Stages gain fits in the 16 spare bits of the accumulators.
+
+        @param R      - the decimation ratio, a power of two
+        @param Stages - the number of integrator and comb stages (1 - 4)
+    */
+    template <uint8_t R, uint8_t Stages> class SDP3xCIC {
+        static_assert((R >= 2) && ((R & (R - 1)) == 0), "SDP3xCIC ratio must be a power of two");
+        static_assert((Stages >= 1) && (Stages <= 4), "SDP3xCIC stages must be 1 - 4");
+        static_assert(Stages * ilog2(R) <= 16, "SDP3xCIC gain must fit in 32 bits");
+
+    private:
+        /* Integrator stages */
+        uint32_t integrator[Stages];
+        /* Previous input of each comb stage */
+        uint32_t comb[Stages];
+        /* The number of values since the last output */
+        uint8_t phase;
+
+    public:
+        /*  Constructor
+
+            @returns a new SDP3xCIC
+        */
+        SDP3xCIC() {
+            reset();
+        }
+
+        /*  Filter the next value
+
+            @param value - the next raw value
+            @param out   - a pointer to store the decimated value
+            @returns true, iff a decimated value was stored
+        */
+        bool update(int16_t value, int16_t *out) {
+            uint32_t acc = (uint32_t)(int32_t)value;
+            uint32_t prev;
+            uint8_t i;
+            for (i = 0; i < Stages; i++) {
+                this->integrator[i] += acc;
+                acc = this->integrator[i];
+            }
+            if (++this->phase < R) {
+                return false;
+            }
+            this->phase = 0;
+            for (i = 0; i < Stages; i++) {
+                prev          = this->comb[i];
+                this->comb[i] = acc;
+                acc -= prev;
+            }
+            // Remove the R^Stages gain
+            *out = (int16_t)((int32_t)acc >> (Stages * ilog2(R)));
+            return true;
+        }
+
+        /*  Decimate many values
+
+            @param in  - the raw values
+            @param n   - the number of raw values
+            @param out - an array of at least n / R + 1 decimated values
+            @returns the number of decimated values stored
+        */
+        uint8_t decimate(const int16_t *in, uint8_t n, int16_t *out) {
+            uint8_t count = 0;
+            for (; n > 0; n--, in++) {
+                if (update(*in, &out[count])) {
+                    count++;
+                }
+            }
+            return count;
+        }
+
+        /*  Forget all previous values
+         */
+        void reset() {
+            uint8_t i;
+            for (i = 0; i < Stages; i++) {
+                this->integrator[i] = 0;
+                this->comb[i]       = 0;
+            }
+            this->phase = 0;
+        }
+    };
+} // namespace SDP3X
+
+#endif
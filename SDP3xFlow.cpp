@@ -0,0 +1,79 @@
+/*
+    SDP3xFlow.cpp - Flow rate from SDP3x differential pressure for orifice and venturi elements.
+
+    Copyright (c) 2018 Bryan T. Meyers
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+    and associated documentation files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+    BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "SDP3xFlow.h"
+
+using namespace SDP3X;
+
+/*  Get the integer square root
+
+    Digit-by-digit method, which needs only shifts and adds (no multiply or divide).
+    @param value - the value to take the root of
+    @returns floor(sqrt(value))
+*/
+uint16_t SDP3X::isqrt32(uint32_t value) {
+    uint32_t root = 0;
+    uint32_t bit  = 1UL << 30;
+    while (bit > value) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint16_t)root;
+}
+
+/*  Constructor
+
+    @param k     - the element constant, in flow units per sqrt(Pa), at most 65535
+    @param scale - the pressure scale of the sensor (ie. SDP31_DiffScale)
+    @returns a new SDP3xFlow for the element
+*/
+SDP3xFlow::SDP3xFlow(float k, uint8_t scale) {
+    float c = k / sqrt((float)scale);
+    // Use as many fraction bits as fit in 16, for the best precision
+    this->shift = 0;
+    while ((this->shift < 23) && ((c * 2.0f) < 65535.0f)) {
+        c *= 2.0f;
+        this->shift++;
+    }
+    this->coefficient = (c < 65535.0f) ? (uint16_t)(c + 0.5f) : 0xFFFF;
+}
+
+/*  Calculate the flow rate
+
+    @param pressure - the raw differential pressure value
+    @returns the flow rate in the units of "k"
+*/
+int32_t SDP3xFlow::getFlow(int16_t pressure) {
+    uint32_t magnitude = (pressure < 0) ? -(int32_t)pressure : pressure;
+    // Shifting left by 16 before the root gives 8 fraction bits, and still fits in 32 bits
+    uint32_t root = isqrt32(magnitude << 16);
+    // root < 2^16 and coefficient < 2^16, so the product cannot overflow, then round
+    int32_t flow = (int32_t)((((root * this->coefficient) >> (this->shift + 7)) + 1) >> 1);
+    return (pressure < 0) ? -flow : flow;
+}
@@ -0,0 +1,66 @@
+/*
+    SDP3xFlow.h - Flow rate from SDP3x differential pressure for orifice and venturi elements.
+
+    Copyright (c) 2018 Bryan T. Meyers
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+    and associated documentation files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+    BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SDP3X_FLOW_H
+#define SDP3X_FLOW_H
+
+#include "SDP3x.h"
+
+namespace SDP3X {
+    /*  Get the integer square root
+
+        @param value - the value to take the root of
+        @returns floor(sqrt(value))
+    */
+    uint16_t isqrt32(uint32_t value);
+
+    /*  The SDP3xFlow class turns raw differential pressure into flow rate
+
+        For an orifice or venturi, flow = K * sqrt(dP). K is folded together with the pressure scale
+        of the sensor into one fixed-point coefficient when the object is made, so each sample only
+        costs an integer square root and a multiply-shift. Negative pressure gives negative flow.
+    */
+    class SDP3xFlow {
+    private:
+        /* K / sqrt(scale), with "shift" fraction bits */
+        uint16_t coefficient;
+        /* Fraction bits of "coefficient" */
+        uint8_t shift;
+
+    public:
+        /*  Constructor
+
+            @param k     - the element constant, in flow units per sqrt(Pa), at most 65535
+            @param scale - the pressure scale of the sensor (ie. SDP31_DiffScale)
+            @returns a new SDP3xFlow for the element
+        */
+        SDP3xFlow(float k, uint8_t scale);
+
+        /*  Calculate the flow rate
+
+            @param pressure - the raw differential pressure value
+            @returns the flow rate in the units of "k"
+        */
+        int32_t getFlow(int16_t pressure);
+    };
+} // namespace SDP3X
+
+#endif
@@ -0,0 +1,144 @@
+/*
+    SDP3xMeasurement.cpp - Bulk reads of SDP3x pressure, temperature and scale.
+
+    Copyright (c) 2018 Bryan T. Meyers
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+    and associated documentation files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+    BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "SDP3xMeasurement.h"
+#include "SDP3xConvert.h"
+
+using namespace SDP3X;
+
+/*  Constructor
+
+    @param tempEvery - read temperature and scale every this many samples (1 for always)
+    @returns a new SDP3xMeasurement, which does a full read first
+*/
+SDP3xMeasurement::SDP3xMeasurement(uint8_t tempEvery) {
+    this->words[0]  = 0;
+    this->words[1]  = 0;
+    this->words[2]  = 0;
+    this->tempEvery = (tempEvery == 0) ? 1 : tempEvery;
+    this->untilTemp = 0;
+    this->fresh     = false;
+    this->known     = false;
+    this->cal       = NULL;
+}
+
+/*  Read a sample from a sensor
+
+    @param sensor - the sensor to read
+    @returns true, iff everything went correctly
+*/
+bool SDP3xMeasurement::read(SDP3x &sensor) {
+    if (this->untilTemp != 0) {
+        if (!sensor.readMeasurement(&this->words[0], NULL, NULL)) {
+            return false;
+        }
+        this->fresh = false;
+        this->untilTemp--;
+        return true;
+    }
+    // A failed read leaves the last good words in place
+    if (!sensor.readMeasurement(&this->words[0], &this->words[1], &this->words[2])) {
+        return false;
+    }
+    this->fresh     = true;
+    this->known     = true;
+    this->untilTemp = this->tempEvery - 1;
+    return true;
+}
+
+/*  Force the next read to include temperature and scale
+ */
+void SDP3xMeasurement::refresh() {
+    this->untilTemp = 0;
+}
+
+/*  Set the zero offset that "getMilliPascal" removes as part of the conversion
+
+    The raw getters are never corrected. The calibration is not copied, so it must outlive this
+    object.
+    @param cal - the calibration of the sensor, NULL for none
+*/
+void SDP3xMeasurement::setCalibration(const SDP3xCalibration *cal) {
+    this->cal = cal;
+}
+
+/*  Get the raw pressure value
+
+    @returns the raw pressure from the last successful read
+*/
+int16_t SDP3xMeasurement::getPressure() {
+    return this->words[0];
+}
+
+/*  Get the raw temperature value
+
+    @returns the raw temperature from the last full read
+*/
+int16_t SDP3xMeasurement::getTemperature() {
+    return this->words[1];
+}
+
+/*  Get the raw pressure scale
+
+    @returns the scale in units of 1/Pa from the last full read
+*/
+int16_t SDP3xMeasurement::getScale() {
+    return this->words[2];
+}
+
+/*  Check if temperature and scale are valid
+
+    @returns true, iff a full read has succeeded
+*/
+bool SDP3xMeasurement::hasTemperature() {
+    return this->known;
+}
+
+/*  Check if temperature and scale came from the last read
+
+    @returns true, iff the last successful read was a full read
+*/
+bool SDP3xMeasurement::isTemperatureFresh() {
+    return this->fresh;
+}
+
+/*  Get the pressure in engineering units
+
+    The zero offset from "setCalibration" is removed, using the last temperature.
+    @returns the pressure in mPa, 0 until a full read has succeeded
+*/
+int32_t SDP3xMeasurement::getMilliPascal() {
+    if (!this->known || (this->words[2] <= 0) || (this->words[2] > 0xFF)) {
+        return 0;
+    }
+    if (this->cal != NULL) {
+        return toMilliPascal(this->words[0], this->words[1], (uint8_t)this->words[2], *this->cal);
+    }
+    return toMilliPascal(this->words[0], (uint8_t)this->words[2]);
+}
+
+/*  Get the temperature in engineering units
+
+    @returns the temperature in mC
+*/
+int32_t SDP3xMeasurement::getMilliCelsius() {
+    return toMilliCelsius(this->words[1]);
+}
@@ -0,0 +1,123 @@
+/*
+    SDP3xMeasurement.h - Bulk reads of SDP3x pressure, temperature and scale.
+
+    Copyright (c) 2018 Bryan T. Meyers
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+    and associated documentation files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+    BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SDP3X_MEASUREMENT_H
+#define SDP3X_MEASUREMENT_H
+
+#include "SDP3x.h"
+#include "SDP3xCalibration.h"
+
+namespace SDP3X {
+    /*  The SDP3xMeasurement class holds every word of a reading from one transaction
+
+        Temperature changes slowly, so the full reading (pressure, temperature and scale) is only
+        read every "tempEvery" samples, and pressure alone the rest of the time. The last
+        temperature and scale are kept in between. Raw words are stored as read, and conversion
+        to engineering units is only done for the getters that are actually called.
+    */
+    class SDP3xMeasurement {
+    private:
+        /* Raw words as read: pressure, temperature and scale */
+        int16_t words[3];
+        /* Number of samples between full reads */
+        uint8_t tempEvery;
+        /* Number of samples until the next full read, 0 if due now */
+        uint8_t untilTemp;
+        /* True iff the last read included temperature and scale */
+        bool fresh;
+        /* True iff temperature and scale have ever been read */
+        bool known;
+        /* The zero offset removed by getMilliPascal, NULL for none */
+        const SDP3xCalibration *cal;
+
+    public:
+        /*  Constructor
+
+            @param tempEvery - read temperature and scale every this many samples (1 for always)
+            @returns a new SDP3xMeasurement, which does a full read first
+        */
+        SDP3xMeasurement(uint8_t tempEvery);
+
+        /*  Read a sample from a sensor
+
+            @param sensor - the sensor to read
+            @returns true, iff everything went correctly
+        */
+        bool read(SDP3x &sensor);
+
+        /*  Force the next read to include temperature and scale
+         */
+        void refresh();
+
+        /*  Set the zero offset that "getMilliPascal" removes as part of the conversion
+
+            The raw getters are never corrected. The calibration is not copied, so it must
+            outlive this object.
+            @param cal - the calibration of the sensor, NULL for none
+        */
+        void setCalibration(const SDP3xCalibration *cal);
+
+        /*  Get the raw pressure value
+
+            @returns the raw pressure from the last successful read
+        */
+        int16_t getPressure();
+
+        /*  Get the raw temperature value
+
+            @returns the raw temperature from the last full read
+        */
+        int16_t getTemperature();
+
+        /*  Get the raw pressure scale
+
+            @returns the scale in units of 1/Pa from the last full read
+        */
+        int16_t getScale();
+
+        /*  Check if temperature and scale are valid
+
+            @returns true, iff a full read has succeeded
+        */
+        bool hasTemperature();
+
+        /*  Check if temperature and scale came from the last read
+
+            @returns true, iff the last successful read was a full read
+        */
+        bool isTemperatureFresh();
+
+        /*  Get the pressure in engineering units
+
+            The zero offset from "setCalibration" is removed, using the last temperature.
+            @returns the pressure in mPa, 0 until a full read has succeeded
+        */
+        int32_t getMilliPascal();
+
+        /*  Get the temperature in engineering units
+
+            @returns the temperature in mC
+        */
+        int32_t getMilliCelsius();
+    };
+} // namespace SDP3X
+
+#endif
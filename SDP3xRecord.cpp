@@ -0,0 +1,264 @@
+/*
+    SDP3xRecord.cpp - Compact binary records of SDP3x samples for logging and telemetry.
+
+    Copyright (c) 2018 Bryan T. Meyers
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+    and associated documentation files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+    BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "SDP3xRecord.h"
+
+using namespace SDP3X;
+
+/*  Append an unsigned varint
+
+    @param out   - where to store the varint
+    @param value - the value to store
+    @returns the number of bytes stored
+*/
+static uint8_t putVarint(uint8_t *out, uint32_t value) {
+    uint8_t length = 1;
+    for (; value >= 0x80; value >>= 7, length++) {
+        *out++ = (uint8_t)value | 0x80;
+    }
+    *out = (uint8_t)value;
+    return length;
+}
+
+/*  Append a signed value as a zigzag varint
+
+    Zigzag maps 0, -1, 1, -2... to 0, 1, 2, 3... so that small changes of either sign are short.
+    @param out   - where to store the varint
+    @param value - the value to store
+    @returns the number of bytes stored
+*/
+static uint8_t putZigzag(uint8_t *out, int32_t value) {
+    return putVarint(out, ((uint32_t)value << 1) ^ (uint32_t)(value >> 31));
+}
+
+/*  Parse an unsigned varint
+
+    @param in     - the varint
+    @param length - the number of bytes available at "in"
+    @param value  - a pointer to store the value
+    @returns the number of bytes used, 0 if incomplete or too long
+*/
+static uint8_t getVarint(const uint8_t *in, uint8_t length, uint32_t *value) {
+    uint8_t used;
+    *value = 0;
+    for (used = 0; (used < length) && (used < 5); used++) {
+        *value |= (uint32_t)(in[used] & 0x7F) << (7 * used);
+        if ((in[used] & 0x80) == 0) {
+            return used + 1;
+        }
+    }
+    return 0;
+}
+
+/*  Parse a zigzag varint
+
+    @param in     - the varint
+    @param length - the number of bytes available at "in"
+    @param value  - a pointer to store the value
+    @returns the number of bytes used, 0 if incomplete or too long
+*/
+static uint8_t getZigzag(const uint8_t *in, uint8_t length, int32_t *value) {
+    uint32_t raw;
+    uint8_t used = getVarint(in, length, &raw);
+    *value       = (int32_t)(raw >> 1) ^ -(int32_t)(raw & 1);
+    return used;
+}
+
+/*  Calculate the CRC of a record
+
+    @param in     - the record
+    @param length - the number of bytes to include
+    @returns the CRC-8, as used by the sensor
+*/
+static uint8_t recordCRC(const uint8_t *in, uint8_t length) {
+    uint8_t crc = 0xFF;
+    for (; length > 0; length--) {
+        crc = crc8(crc, *in++);
+    }
+    return crc;
+}
+
+/*  Constructor
+
+    @param interval - emit a keyframe every "interval" records, 0 for only the first and after
+                      "reset"
+    @returns a new SDP3xRecordWriter, which starts with a keyframe
+*/
+SDP3xRecordWriter::SDP3xRecordWriter(uint8_t interval) {
+    this->interval = interval;
+    reset();
+}
+
+/*  Encode a sample
+
+    Both "temp" and "scale" should be left NULL if not recorded.
+    @param out      - where to store the record, at least RecordMaxSize bytes
+    @param addr     - the I2C address of the sensor
+    @param time     - when the sample was taken, ie. from micros()
+    @param pressure - the raw pressure value
+    @param temp     - if not null, the raw temperature value
+    @param scale    - if not null, the raw pressure scale
+    @returns the number of bytes stored
+*/
+uint8_t SDP3xRecordWriter::write(uint8_t *out, uint8_t addr, unsigned long time, int16_t pressure,
+                                 const int16_t *temp, const int16_t *scale) {
+    uint8_t length = 2;
+    uint8_t flags  = 0;
+    if ((this->interval != 0) && (this->since >= this->interval)) {
+        this->keyframe = true;
+    }
+    if (this->keyframe) {
+        flags |= RecordKeyframe;
+        this->lastTime     = 0;
+        this->lastPressure = 0;
+        this->lastTemp     = 0;
+        this->keyframe     = false;
+        this->since        = 0;
+    }
+    this->since++;
+    length += putVarint(&out[length], time - this->lastTime);
+    length += putZigzag(&out[length], (int32_t)pressure - this->lastPressure);
+    this->lastTime     = time;
+    this->lastPressure = pressure;
+    if (temp != NULL) {
+        flags |= RecordHasTemp;
+        length += putZigzag(&out[length], (int32_t)*temp - this->lastTemp);
+        this->lastTemp = *temp;
+    }
+    if (scale != NULL) {
+        flags |= RecordHasScale;
+        length += putZigzag(&out[length], *scale);
+    }
+    out[0]      = addr;
+    out[1]      = flags;
+    out[length] = recordCRC(out, length);
+    return length + 1;
+}
+
+/*  Make the next record a keyframe, so a reader can start from it
+ */
+void SDP3xRecordWriter::reset() {
+    this->keyframe = true;
+    this->since    = 0;
+}
+
+/*  Constructor
+
+    @returns a new SDP3xRecordReader, which waits for a keyframe
+*/
+SDP3xRecordReader::SDP3xRecordReader() {
+    this->synced = false;
+}
+
+/*  Decode a record
+
+    Records before the first keyframe cannot be decoded and are skipped. A corrupt record (bad CRC,
+    flags or varint) loses sync, so every record is skipped until the next keyframe. The length of
+    a skipped or corrupt record is still returned, so that a parser can move on to the next one, and
+    "isSynced" tells whether the outputs were stored.
+    @param in       - the record
+    @param length   - the number of bytes available at "in"
+    @param addr     - a pointer to store the I2C address of the sensor
+    @param time     - a pointer to store the time the sample was taken
+    @param pressure - a pointer to store the raw pressure value
+    @param temp     - if not null, a pointer to store the raw temperature value
+    @param scale    - if not null, a pointer to store the raw pressure scale
+    @param flags    - if not null, a pointer to store the record flags
+    @returns the number of bytes used, 0 iff the record is incomplete
+*/
+uint8_t SDP3xRecordReader::read(const uint8_t *in, uint8_t length, uint8_t *addr,
+                                unsigned long *time, int16_t *pressure, int16_t *temp,
+                                int16_t *scale, uint8_t *flags) {
+    uint32_t dt;
+    int32_t dp;
+    int32_t dtemp  = 0;
+    int32_t rscale = 0;
+    uint8_t used   = 2;
+    uint8_t n      = 1;
+    if (length < 4) {
+        return 0;
+    }
+    if ((in[1] & ~(RecordKeyframe | RecordHasTemp | RecordHasScale)) != 0) {
+        // Unknown flags, so the length cannot be trusted either: move on by a single byte
+        this->synced = false;
+        return 1;
+    }
+    // Parse every field before touching any state, in case the record is bad
+    n = getVarint(&in[used], length - used, &dt);
+    used += n;
+    if (n != 0) {
+        n = getZigzag(&in[used], length - used, &dp);
+        used += n;
+    }
+    if ((n != 0) && (in[1] & RecordHasTemp)) {
+        n = getZigzag(&in[used], length - used, &dtemp);
+        used += n;
+    }
+    if ((n != 0) && (in[1] & RecordHasScale)) {
+        n = getZigzag(&in[used], length - used, &rscale);
+        used += n;
+    }
+    if ((n == 0) || (used >= length)) {
+        // Every valid record fits in RecordMaxSize, so with that much available it is corrupt
+        if (length < RecordMaxSize) {
+            return 0;
+        }
+        this->synced = false;
+        return 1;
+    }
+    if (in[used] != recordCRC(in, used)) {
+        this->synced = false;
+        return used + 1;
+    }
+    if (in[1] & RecordKeyframe) {
+        this->lastTime     = 0;
+        this->lastPressure = 0;
+        this->lastTemp     = 0;
+        this->synced       = true;
+    }
+    if (!this->synced) {
+        return used + 1;
+    }
+    this->lastTime += dt;
+    this->lastPressure += dp;
+    this->lastTemp += dtemp;
+    *addr     = in[0];
+    *time     = this->lastTime;
+    *pressure = this->lastPressure;
+    if (temp != NULL) {
+        *temp = this->lastTemp;
+    }
+    if (scale != NULL) {
+        *scale = (int16_t)rscale;
+    }
+    if (flags != NULL) {
+        *flags = in[1];
+    }
+    return used + 1;
+}
+
+/*  Check if the last record read was decoded
+
+    @returns true, iff a keyframe has been read and no record since was corrupt
+*/
+bool SDP3xRecordReader::isSynced() {
+    return this->synced;
+}
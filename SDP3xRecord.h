@@ -0,0 +1,144 @@
+/*
+    SDP3xRecord.h - Compact binary records of SDP3x samples for logging and telemetry.
+
+    Copyright (c) 2018 Bryan T. Meyers
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+    and associated documentation files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+    BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SDP3X_RECORD_H
+#define SDP3X_RECORD_H
+
+#include "SDP3x.h"
+
+namespace SDP3X {
+    /*  Record Format
+
+        | Field    | Size    | Description                                                    |
+        | addr     | 1       | the I2C address of the sensor                                  |
+        | flags    | 1       | RecordKeyframe, RecordHasTemp and RecordHasScale               |
+        | time     | 1 - 5   | varint, us since the previous record                           |
+        | pressure | 1 - 3   | zigzag varint, change in raw pressure since the previous record |
+        | temp     | 1 - 3   | zigzag varint, change in raw temperature, iff RecordHasTemp    |
+        | scale    | 1 - 3   | zigzag varint, the raw scale, iff RecordHasScale               |
+        | crc      | 1       | CRC-8 (same as the sensor) of every previous byte              |
+
+        Varints hold 7 bits per byte, least significant first, with the top bit set on every byte
+        but the last. Deltas are against the previous record of the same writer, or against zero
+        for a keyframe, so a slowly changing signal needs only a byte or two per field.
+
+        A lost or corrupt record breaks the chain of deltas, so writers emit a keyframe every
+        RecordKeyframeInterval records by default, and readers skip records until the next one.
+    */
+    const uint8_t RecordKeyframe         = 0x01;
+    const uint8_t RecordHasTemp          = 0x02;
+    const uint8_t RecordHasScale         = 0x04;
+    const uint8_t RecordMaxSize          = 17;
+    const uint8_t RecordKeyframeInterval = 64;
+
+    /*  The SDP3xRecordWriter class encodes samples from one sensor into records
+
+        Use one writer per sensor, since each record is a delta against the previous one.
+    */
+    class SDP3xRecordWriter {
+    private:
+        /* Time of the previous record in us */
+        unsigned long lastTime;
+        /* Raw values of the previous record */
+        int16_t lastPressure;
+        int16_t lastTemp;
+        /* True iff the next record must be a keyframe */
+        bool keyframe;
+        /* Records between keyframes, 0 for only the first and after "reset" */
+        uint8_t interval;
+        /* Records written since the last keyframe */
+        uint8_t since;
+
+    public:
+        /*  Constructor
+
+            @param interval - emit a keyframe every "interval" records, 0 for only the first and
+                              after "reset"
+            @returns a new SDP3xRecordWriter, which starts with a keyframe
+        */
+        SDP3xRecordWriter(uint8_t interval = RecordKeyframeInterval);
+
+        /*  Encode a sample
+
+            Both "temp" and "scale" should be left NULL if not recorded.
+            @param out      - where to store the record, at least RecordMaxSize bytes
+            @param addr     - the I2C address of the sensor
+            @param time     - when the sample was taken, ie. from micros()
+            @param pressure - the raw pressure value
+            @param temp     - if not null, the raw temperature value
+            @param scale    - if not null, the raw pressure scale
+            @returns the number of bytes stored
+        */
+        uint8_t write(uint8_t *out, uint8_t addr, unsigned long time, int16_t pressure,
+                      const int16_t *temp, const int16_t *scale);
+
+        /*  Make the next record a keyframe, so a reader can start from it
+         */
+        void reset();
+    };
+
+    /*  The SDP3xRecordReader class decodes records from one SDP3xRecordWriter
+     */
+    class SDP3xRecordReader {
+    private:
+        /* Time of the previous record in us */
+        unsigned long lastTime;
+        /* Raw values of the previous record */
+        int16_t lastPressure;
+        int16_t lastTemp;
+        /* True iff a keyframe has been read, and every record since was decoded */
+        bool synced;
+
+    public:
+        /*  Constructor
+
+            @returns a new SDP3xRecordReader, which waits for a keyframe
+        */
+        SDP3xRecordReader();
+
+        /*  Decode a record
+
+            Records before the first keyframe cannot be decoded and are skipped. A corrupt record
+            (bad CRC, flags or varint) loses sync, so every record is skipped until the next
+            keyframe. The length of a skipped or corrupt record is still returned, so that a parser
+            can move on to the next one, and "isSynced" tells whether the outputs were stored.
+            @param in       - the record
+            @param length   - the number of bytes available at "in"
+            @param addr     - a pointer to store the I2C address of the sensor
+            @param time     - a pointer to store the time the sample was taken
+            @param pressure - a pointer to store the raw pressure value
+            @param temp     - if not null, a pointer to store the raw temperature value
+            @param scale    - if not null, a pointer to store the raw pressure scale
+            @param flags    - if not null, a pointer to store the record flags
+            @returns the number of bytes used, 0 iff the record is incomplete
+        */
+        uint8_t read(const uint8_t *in, uint8_t length, uint8_t *addr, unsigned long *time,
+                     int16_t *pressure, int16_t *temp, int16_t *scale, uint8_t *flags);
+
+        /*  Check if the last record read was decoded
+
+            @returns true, iff a keyframe has been read and no record since was corrupt
+        */
+        bool isSynced();
+    };
+} // namespace SDP3X
+
+#endif
@@ -0,0 +1,227 @@
+/*
+    SDP3xRecovery.cpp - Bus recovery and per-sensor re-initialization for SDP3x sensors.
+
+    Copyright (c) 2018 Bryan T. Meyers
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+    and associated documentation files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+    BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "SDP3xRecovery.h"
+
+using namespace SDP3X;
+
+/*  Bound every transaction on a bus, so a stuck device cannot block forever
+
+    Only supported by cores that provide Wire timeouts (ie. AVR since 1.8.2, flagged by
+    WIRE_HAS_TIMEOUT). A timed out transaction fails and the bus is reset by the core.
+    @param wire    - the bus to bound
+    @param timeout - the longest transaction in us
+    @returns true, iff the core supports timeouts
+*/
+bool SDP3X::setBusTimeout(TwoWire &wire, uint32_t timeout) {
+#ifdef WIRE_HAS_TIMEOUT
+    wire.setWireTimeout(timeout, true);
+    return true;
+#else
+    (void)wire;
+    (void)timeout;
+    return false;
+#endif
+}
+
+/*  Free a bus from a device that is holding SDA low
+
+    Clocks SCL up to 9 times until SDA is released, then sends a STOP. The bus must be stopped with
+    end() first: on AVR the TWI owns both pins while it is enabled, so the pin writes here would
+    have no effect. Start the bus again with begin() afterwards.
+    @param sda - the pin used for SDA
+    @param scl - the pin used for SCL
+    @returns true, iff SDA is released
+*/
+bool SDP3X::clearBus(uint8_t sda, uint8_t scl) {
+    uint8_t i;
+    pinMode(sda, INPUT_PULLUP);
+    pinMode(scl, INPUT_PULLUP);
+    // 5us half-periods keep to 100kHz, which every device supports
+    for (i = 0; (i < 9) && (digitalRead(sda) == LOW); i++) {
+        pinMode(scl, OUTPUT);
+        digitalWrite(scl, LOW);
+        delayMicroseconds(5);
+        pinMode(scl, INPUT_PULLUP);
+        delayMicroseconds(5);
+    }
+    if (digitalRead(sda) == LOW) {
+        return false;
+    }
+    // STOP: SDA rises while SCL is high
+    pinMode(sda, OUTPUT);
+    digitalWrite(sda, LOW);
+    delayMicroseconds(5);
+    pinMode(sda, INPUT_PULLUP);
+    delayMicroseconds(5);
+    return digitalRead(sda) == HIGH;
+}
+
+/*  Stop a bus, free it with "clearBus" and start it again
+
+    begin() sets the core's default clock, so the clock is set again, and the timeout is applied
+    with "setBusTimeout".
+    @param wire    - the bus to reset
+    @param sda     - the pin used for SDA by this bus
+    @param scl     - the pin used for SCL by this bus
+    @param clock   - the I2C clock to restore in Hz
+    @param timeout - the longest transaction in us, 0 to leave transactions unbounded
+    @returns true, iff SDA is released
+*/
+bool SDP3X::resetBus(TwoWire &wire, uint8_t sda, uint8_t scl, uint32_t clock, uint32_t timeout) {
+    bool released;
+    wire.end();
+    released = clearBus(sda, scl);
+    wire.begin();
+    wire.setClock(clock);
+    if (timeout != 0) {
+        setBusTimeout(wire, timeout);
+    }
+    return released;
+}
+
+/*  Constructor
+
+    @param sensor - the sensor to supervise, which must outlive the supervisor
+    @returns a new SDP3xSupervisor, with the sensor online
+*/
+SDP3xSupervisor::SDP3xSupervisor(SDP3x &sensor) {
+    this->sensor     = &sensor;
+    this->retryAt    = 0;
+    this->backoff    = RecoveryMinBackoff;
+    this->failures   = 0;
+    this->offline    = false;
+    this->continuous = false;
+    this->averaging  = false;
+    this->wire       = NULL;
+    this->sda        = 0;
+    this->scl        = 0;
+    this->clock      = 0;
+    this->timeout    = 0;
+}
+
+/*  Reset the bus during recovery whenever it is found stuck, and bound its transactions
+
+    The timeout is applied at once with "setBusTimeout", and again after every reset.
+    @param wire    - the bus the sensor is on
+    @param sda     - the pin used for SDA by this bus
+    @param scl     - the pin used for SCL by this bus
+    @param clock   - the I2C clock to restore after a reset in Hz
+    @param timeout - the longest transaction in us, 0 to leave transactions unbounded
+    @returns true, iff the core supports timeouts, or none was asked for
+*/
+bool SDP3xSupervisor::setBusRecovery(TwoWire &wire, uint8_t sda, uint8_t scl, uint32_t clock,
+                                     uint32_t timeout) {
+    this->wire    = &wire;
+    this->sda     = sda;
+    this->scl     = scl;
+    this->clock   = clock;
+    this->timeout = timeout;
+    return (timeout == 0) || setBusTimeout(wire, timeout);
+}
+
+/*  Begin taking continuous readings, and restart them after every recovery
+
+    @param averaging - average samples until read occurs, otherwise read last value only
+    @returns true, iff everything went correctly
+*/
+bool SDP3xSupervisor::startContinuous(bool averaging) {
+    this->continuous = true;
+    this->averaging  = averaging;
+    return this->sensor->startContinuous(averaging);
+}
+
+/*  Disable continuous measurements, and stop restarting them after recovery
+
+    @returns true, iff everything went correctly
+*/
+bool SDP3xSupervisor::stopContinuous() {
+    this->continuous = false;
+    return this->sensor->stopContinuous();
+}
+
+/*  Get a reading, or attempt recovery if due
+
+    @param pressure - a pointer to store the raw pressure value
+    @param temp     - a pointer to store the raw temperature value
+    @param scale    - a pointer to store the pressure scaling factor
+    @returns true, iff everything went correctly
+*/
+bool SDP3xSupervisor::read(int16_t *pressure, int16_t *temp, int16_t *scale) {
+    unsigned long now;
+    if (this->offline) {
+        now = millis();
+        if ((long)(now - this->retryAt) < 0) {
+            return false;
+        }
+        // A device holding SDA low blocks every transaction, so free the bus first
+        if ((this->wire != NULL) && (digitalRead(this->sda) == LOW)) {
+            resetBus(*this->wire, this->sda, this->scl, this->clock, this->timeout);
+        }
+        /*  The sensor may have kept its power and still be in continuous mode, where it rejects
+            everything but a stop, or may have lost it and need to be identified again
+        */
+        this->sensor->stopContinuous();
+        delay(ContStopTime);
+        if (!this->sensor->begin() ||
+            (this->continuous && !this->sensor->startContinuous(this->averaging))) {
+            this->retryAt = now + this->backoff;
+            this->backoff = (this->backoff > RecoveryMaxBackoff / 2) ? RecoveryMaxBackoff
+                                                                     : this->backoff * 2;
+            return false;
+        }
+        this->offline  = false;
+        this->failures = 0;
+        this->backoff  = RecoveryMinBackoff;
+        if (this->continuous) {
+            // Nothing will be available until the first continuous reading
+            return false;
+        }
+    }
+    if (this->sensor->readMeasurement(pressure, temp, scale)) {
+        this->failures = 0;
+        return true;
+    }
+    if (this->failures < 0xFF) {
+        this->failures++;
+    }
+    if (this->failures >= RecoveryMaxFailures) {
+        this->offline = true;
+        this->retryAt = millis() + this->backoff;
+    }
+    return false;
+}
+
+/*  Check if the sensor is in service
+
+    @returns true, iff the sensor has not been taken offline
+*/
+bool SDP3xSupervisor::isOnline() {
+    return !this->offline;
+}
+
+/*  Get the number of consecutive failed reads
+
+    @returns the failure count, saturating at 255
+*/
+uint8_t SDP3xSupervisor::getFailures() {
+    return this->failures;
+}
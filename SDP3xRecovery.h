@@ -0,0 +1,161 @@
+/*
+    SDP3xRecovery.h - Bus recovery and per-sensor re-initialization for SDP3x sensors.
+
+    Copyright (c) 2018 Bryan T. Meyers
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+    and associated documentation files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+    BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SDP3X_RECOVERY_H
+#define SDP3X_RECOVERY_H
+
+#include "SDP3x.h"
+
+namespace SDP3X {
+    /* Consecutive failed reads before a sensor is taken offline */
+    const uint8_t RecoveryMaxFailures = 3;
+    /* First and longest wait between re-initialization attempts, in ms */
+    const uint16_t RecoveryMinBackoff = 10;
+    const uint16_t RecoveryMaxBackoff = 10000;
+
+    /*  Bound every transaction on a bus, so a stuck device cannot block forever
+
+        Only supported by cores that provide Wire timeouts (ie. AVR since 1.8.2, flagged by
+        WIRE_HAS_TIMEOUT). A timed out transaction fails and the bus is reset by the core.
+        @param wire    - the bus to bound
+        @param timeout - the longest transaction in us
+        @returns true, iff the core supports timeouts
+    */
+    bool setBusTimeout(TwoWire &wire, uint32_t timeout);
+
+    /*  Free a bus from a device that is holding SDA low
+
+        Clocks SCL up to 9 times until SDA is released, then sends a STOP. The bus must be stopped
+        with end() first: on AVR the TWI owns both pins while it is enabled, so the pin writes here
+        would have no effect. Start the bus again with begin() afterwards.
+        @param sda - the pin used for SDA
+        @param scl - the pin used for SCL
+        @returns true, iff SDA is released
+    */
+    bool clearBus(uint8_t sda, uint8_t scl);
+
+    /*  Stop a bus, free it with "clearBus" and start it again
+
+        begin() sets the core's default clock, so the clock is set again, and the timeout is
+        applied with "setBusTimeout".
+        @param wire    - the bus to reset
+        @param sda     - the pin used for SDA by this bus
+        @param scl     - the pin used for SCL by this bus
+        @param clock   - the I2C clock to restore in Hz
+        @param timeout - the longest transaction in us, 0 to leave transactions unbounded
+        @returns true, iff SDA is released
+    */
+    bool resetBus(TwoWire &wire, uint8_t sda, uint8_t scl, uint32_t clock, uint32_t timeout);
+
+    /*  The SDP3xSupervisor class takes a failing sensor offline and brings it back
+
+        After RecoveryMaxFailures consecutive failed reads, the sensor is offline and reads fail
+        at once without touching the bus, so the other sensors keep their sample rate. It is then
+        re-initialized with "begin" after a backoff that doubles on every failed attempt, from
+        RecoveryMinBackoff to RecoveryMaxBackoff. Continuous mode is stopped first, since a sensor
+        that kept its power is still running and rejects every other command. Soft reset is not
+        used, since it would reset every device on the bus.
+
+        If "setBusRecovery" was called, a bus found with SDA held low is reset with "resetBus"
+        before each attempt. Otherwise the bus is left alone.
+    */
+    class SDP3xSupervisor {
+    private:
+        /* The sensor being supervised */
+        SDP3x *sensor;
+        /* Time in ms of the next re-initialization attempt */
+        unsigned long retryAt;
+        /* Current wait between re-initialization attempts in ms */
+        uint16_t backoff;
+        /* Consecutive failed reads */
+        uint8_t failures;
+        /* True iff the sensor is offline */
+        bool offline;
+        /* Restart continuous mode after re-initialization */
+        bool continuous;
+        /* Use averaging when restarting continuous mode */
+        bool averaging;
+        /* The bus to reset if it is stuck, NULL if not configured */
+        TwoWire *wire;
+        /* Pins, clock and timeout used to reset the bus */
+        uint8_t sda;
+        uint8_t scl;
+        uint32_t clock;
+        uint32_t timeout;
+
+    public:
+        /*  Constructor
+
+            @param sensor - the sensor to supervise, which must outlive the supervisor
+            @returns a new SDP3xSupervisor, with the sensor online
+        */
+        SDP3xSupervisor(SDP3x &sensor);
+
+        /*  Reset the bus during recovery whenever it is found stuck, and bound its transactions
+
+            The timeout is applied at once with "setBusTimeout", and again after every reset.
+            @param wire    - the bus the sensor is on
+            @param sda     - the pin used for SDA by this bus
+            @param scl     - the pin used for SCL by this bus
+            @param clock   - the I2C clock to restore after a reset in Hz
+            @param timeout - the longest transaction in us, 0 to leave transactions unbounded
+            @returns true, iff the core supports timeouts, or none was asked for
+        */
+        bool setBusRecovery(TwoWire &wire, uint8_t sda, uint8_t scl, uint32_t clock,
+                            uint32_t timeout);
+
+        /*  Begin taking continuous readings, and restart them after every recovery
+
+            @param averaging - average samples until read occurs, otherwise read last value only
+            @returns true, iff everything went correctly
+        */
+        bool startContinuous(bool averaging);
+
+        /*  Disable continuous measurements, and stop restarting them after recovery
+
+            @returns true, iff everything went correctly
+        */
+        bool stopContinuous();
+
+        /*  Get a reading, or attempt recovery if due
+
+            @param pressure - a pointer to store the raw pressure value
+            @param temp     - a pointer to store the raw temperature value
+            @param scale    - a pointer to store the pressure scaling factor
+            @returns true, iff everything went correctly
+        */
+        bool read(int16_t *pressure, int16_t *temp, int16_t *scale);
+
+        /*  Check if the sensor is in service
+
+            @returns true, iff the sensor has not been taken offline
+        */
+        bool isOnline();
+
+        /*  Get the number of consecutive failed reads
+
+            @returns the failure count, saturating at 255
+        */
+        uint8_t getFailures();
+    };
+} // namespace SDP3X
+
+#endif
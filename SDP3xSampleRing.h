@@ -0,0 +1,188 @@
+/*
+    SDP3xSampleRing.h - Fixed-size ring buffer for continuous SDP3x samples.
+
+    Copyright (c) 2018 Bryan T. Meyers
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+    and associated documentation files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+    BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SDP3X_SAMPLE_RING_H
+#define SDP3X_SAMPLE_RING_H
+
+#include "SDP3x.h"
+
+namespace SDP3X {
+    /*  SDP3xSampleRing is a fixed-size, allocation-free queue of raw samples
+
+        It is safe to fill from exactly one context while draining from exactly one other context.
+        Only "push" may be called from an ISR. "fill" reads over I2C, and Wire.requestFrom waits
+        on the TWI interrupt, which cannot run inside another ISR on AVR, ergo "fill" must only be
+        called from loop or a task. The positions are single bytes so that they are updated
+        atomically on AVR, ergo N must be a power of two no greater than 128.
+
+        @param N - the number of samples that can be held
+    */
+    template <uint8_t N> class SDP3xSampleRing {
+        static_assert((N > 0) && (N <= 128) && ((N & (N - 1)) == 0),
+                      "SDP3xSampleRing size must be a power of two no greater than 128");
+
+    private:
+        /* Raw pressure values */
+        volatile int16_t pressure[N];
+        /* Raw temperature values */
+        volatile int16_t temp[N];
+        /* Free-running count of samples pushed */
+        volatile uint8_t head;
+        /* Free-running count of samples popped */
+        volatile uint8_t tail;
+        /* Number of samples dropped because the ring was full */
+        volatile uint8_t dropped;
+
+    public:
+        /*  Constructor
+
+            @returns a new, empty SDP3xSampleRing
+        */
+        SDP3xSampleRing() {
+            this->head    = 0;
+            this->tail    = 0;
+            this->dropped = 0;
+        }
+
+        /*  Add a sample, from the filling context only
+
+            This makes no I2C transaction, so it is safe to call from an ISR.
+            @param pressure - the raw pressure value
+            @param temp     - the raw temperature value
+            @returns true, iff there was room for the sample
+        */
+        bool push(int16_t pressure, int16_t temp) {
+            uint8_t h = this->head;
+            if ((uint8_t)(h - this->tail) >= N) {
+                if (this->dropped < 0xFF) {
+                    this->dropped++;
+                }
+                return false;
+            }
+            this->pressure[h & (N - 1)] = pressure;
+            this->temp[h & (N - 1)]     = temp;
+            // Only publish the sample once it has been stored
+            this->head = h + 1;
+            return true;
+        }
+
+        /*  Read a measurement from a sensor and add it, from the filling context only
+
+            This is meant to be called from loop or a task while the sensor is in continuous
+            mode. Never call it from an ISR, since the I2C read would hang waiting on the bus.
+            @param sensor   - the sensor to read
+            @param withTemp - also read the temperature, otherwise it is stored as 0
+            @returns true, iff the read succeeded and there was room for the sample
+        */
+        bool fill(SDP3x &sensor, bool withTemp) {
+            int16_t p = 0;
+            int16_t t = 0;
+            if (!sensor.readMeasurement(&p, withTemp ? &t : NULL, NULL)) {
+                return false;
+            }
+            return push(p, t);
+        }
+
+        /*  Read a measurement, pass it to a hook and add it, from the filling context only
+
+            The hook is any object with an "update(int16_t pressure)" member (ie. SDP3xAlarm),
+            so the ring does not depend on it. It sees every reading even if the ring is full, so
+            alarms are raised in the filling context without waiting for the ring to be drained.
+            As for the other "fill", this must only be called from loop or a task, never from an
+            ISR.
+            @param sensor   - the sensor to read
+            @param withTemp - also read the temperature, otherwise it is stored as 0
+            @param hook     - the object to update with each raw pressure reading
+            @returns true, iff the read succeeded and there was room for the sample
+        */
+        template <class Hook> bool fill(SDP3x &sensor, bool withTemp, Hook &hook) {
+            int16_t p = 0;
+            int16_t t = 0;
+            if (!sensor.readMeasurement(&p, withTemp ? &t : NULL, NULL)) {
+                return false;
+            }
+            hook.update(p);
+            return push(p, t);
+        }
+
+        /*  Remove the oldest sample, from the draining context only
+
+            @param pressure - if not null, a pointer to store the raw pressure value
+            @param temp     - if not null, a pointer to store the raw temperature value
+            @returns true, iff a sample was available
+        */
+        bool pop(int16_t *pressure, int16_t *temp) {
+            return drain(pressure, temp, 1) == 1;
+        }
+
+        /*  Remove up to "max" of the oldest samples, from the draining context only
+
+            @param pressure - if not null, an array of at least "max" raw pressure values
+            @param temp     - if not null, an array of at least "max" raw temperature values
+            @param max      - the most samples to remove
+            @returns the number of samples removed
+        */
+        uint8_t drain(int16_t *pressure, int16_t *temp, uint8_t max) {
+            uint8_t t     = this->tail;
+            uint8_t count = this->head - t;
+            uint8_t i;
+            if (count > max) {
+                count = max;
+            }
+            for (i = 0; i < count; i++, t++) {
+                if (pressure != NULL) {
+                    pressure[i] = this->pressure[t & (N - 1)];
+                }
+                if (temp != NULL) {
+                    temp[i] = this->temp[t & (N - 1)];
+                }
+            }
+            // Only release the slots once they have been copied out
+            this->tail = t;
+            return count;
+        }
+
+        /*  Get the number of samples waiting to be drained
+
+            @returns the number of samples held
+        */
+        uint8_t available() {
+            return (uint8_t)(this->head - this->tail);
+        }
+
+        /*  Get the number of samples lost because the ring was full
+
+            @returns the number of dropped samples, saturating at 255
+        */
+        uint8_t overruns() {
+            return this->dropped;
+        }
+
+        /*  Discard every sample and reset the overrun count, from the draining context only
+         */
+        void clear() {
+            this->tail    = this->head;
+            this->dropped = 0;
+        }
+    };
+} // namespace SDP3X
+
+#endif
@@ -0,0 +1,131 @@
+/*
+    SDP3xScheduler.cpp - Data-ready scheduling for SDP3x sensors.
+
+    Copyright (c) 2018 Bryan T. Meyers
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+    and associated documentation files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+    BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "SDP3xScheduler.h"
+
+using namespace SDP3X;
+
+/*  Constructor
+
+    @param sensor - the sensor to schedule, which must outlive the scheduler
+    @returns a new SDP3xScheduler with nothing pending
+*/
+SDP3xScheduler::SDP3xScheduler(SDP3x &sensor) {
+    this->sensor     = &sensor;
+    this->ready      = 0;
+    this->armed      = false;
+    this->continuous = false;
+}
+
+/*  Begin taking continuous readings
+
+    @param averaging - average samples until read occurs, otherwise read last value only
+    @returns true, iff everything went correctly
+*/
+bool SDP3xScheduler::startContinuous(bool averaging) {
+    if (!this->sensor->startContinuous(averaging)) {
+        return false;
+    }
+    this->ready      = micros() + ContStartTime * 1000UL;
+    this->armed      = true;
+    this->continuous = true;
+    return true;
+}
+
+/*  Disable continuous measurements
+
+    @returns true, iff everything went correctly
+*/
+bool SDP3xScheduler::stopContinuous() {
+    this->armed      = false;
+    this->continuous = false;
+    return this->sensor->stopContinuous();
+}
+
+/*  Start a one-shot reading, without clock stretching
+
+    @returns true, iff everything went correctly
+*/
+bool SDP3xScheduler::trigger() {
+    if (!this->sensor->triggerMeasurement(false)) {
+        return false;
+    }
+    this->ready = micros() + TrigSettleTime * 1000UL;
+    this->armed = true;
+    return true;
+}
+
+/*  Check if a fresh reading is available
+
+    @returns true, iff a reading is expected and enough time has passed for it
+*/
+bool SDP3xScheduler::isReady() {
+    // Signed difference, so that micros() wrapping around is handled
+    return this->armed && ((long)(micros() - this->ready) >= 0);
+}
+
+/*  Get the time left until a fresh reading is available
+
+    @returns the time in us, 0 if ready now or if no reading is expected
+*/
+unsigned long SDP3xScheduler::timeUntilReady() {
+    long left = (long)(this->ready - micros());
+    if (!this->armed || (left <= 0)) {
+        return 0;
+    }
+    return (unsigned long)left;
+}
+
+/*  Account for time that passed without micros() advancing
+
+    On AVR, micros() is driven by Timer0, which stops in power-down sleep. Call this after waking
+    with the time actually slept (ie. from the watchdog period), so that a reading that settled
+    during sleep is seen as ready.
+    @param us - the time slept in us
+*/
+void SDP3xScheduler::addSleptTime(unsigned long us) {
+    this->ready -= us;
+}
+
+/*  Get a fresh reading, if there is one
+
+    No I2C transaction is made unless "isReady" is true. Both "temp" and "scale" should be left
+    NULL if not used. This will reduce read times.
+    @param pressure - a pointer to store the raw pressure value
+    @param temp     - a pointer to store the raw temperature value
+    @param scale    - a pointer to store the pressure scaling factor
+    @returns true, iff a fresh reading was read correctly
+*/
+bool SDP3xScheduler::read(int16_t *pressure, int16_t *temp, int16_t *scale) {
+    if (!isReady()) {
+        return false;
+    }
+    if (!this->sensor->readMeasurement(pressure, temp, scale)) {
+        return false;
+    }
+    if (this->continuous) {
+        // The next reading replaces this one after the update interval
+        this->ready = micros() + ContUpdateTime * 1000UL;
+    } else {
+        this->armed = false;
+    }
+    return true;
+}
@@ -0,0 +1,106 @@
+/*
+    SDP3xScheduler.h - Data-ready scheduling for SDP3x sensors.
+
+    Copyright (c) 2018 Bryan T. Meyers
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+    and associated documentation files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+    BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SDP3X_SCHEDULER_H
+#define SDP3X_SCHEDULER_H
+
+#include "SDP3x.h"
+
+namespace SDP3X {
+    /*  The SDP3xScheduler class tracks when a sensor will next have a fresh reading
+
+        Reads are only sent to the sensor once a new value exists, so no bus time is spent on
+        reads that would fail or return a repeat, and loop() is free to do other work until then.
+        Clock stretching is never used.
+    */
+    class SDP3xScheduler {
+    private:
+        /* The sensor being scheduled */
+        SDP3x *sensor;
+        /* Time in us at which the next reading will be available */
+        unsigned long ready;
+        /* True iff a reading is expected (triggered, or continuous mode running) */
+        bool armed;
+        /* True iff the sensor is in continuous mode */
+        bool continuous;
+
+    public:
+        /*  Constructor
+
+            @param sensor - the sensor to schedule, which must outlive the scheduler
+            @returns a new SDP3xScheduler with nothing pending
+        */
+        SDP3xScheduler(SDP3x &sensor);
+
+        /*  Begin taking continuous readings
+
+            @param averaging - average samples until read occurs, otherwise read last value only
+            @returns true, iff everything went correctly
+        */
+        bool startContinuous(bool averaging);
+
+        /*  Disable continuous measurements
+
+            @returns true, iff everything went correctly
+        */
+        bool stopContinuous();
+
+        /*  Start a one-shot reading, without clock stretching
+
+            @returns true, iff everything went correctly
+        */
+        bool trigger();
+
+        /*  Check if a fresh reading is available
+
+            @returns true, iff a reading is expected and enough time has passed for it
+        */
+        bool isReady();
+
+        /*  Get the time left until a fresh reading is available
+
+            @returns the time in us, 0 if ready now or if no reading is expected
+        */
+        unsigned long timeUntilReady();
+
+        /*  Account for time that passed without micros() advancing
+
+            On AVR, micros() is driven by Timer0, which stops in power-down sleep. Call this after
+            waking with the time actually slept (ie. from the watchdog period), so that a reading
+            that settled during sleep is seen as ready.
+            @param us - the time slept in us
+        */
+        void addSleptTime(unsigned long us);
+
+        /*  Get a fresh reading, if there is one
+
+            No I2C transaction is made unless "isReady" is true. Both "temp" and "scale" should be
+            left NULL if not used. This will reduce read times.
+            @param pressure - a pointer to store the raw pressure value
+            @param temp     - a pointer to store the raw temperature value
+            @param scale    - a pointer to store the pressure scaling factor
+            @returns true, iff a fresh reading was read correctly
+        */
+        bool read(int16_t *pressure, int16_t *temp, int16_t *scale);
+    };
+} // namespace SDP3X
+
+#endif
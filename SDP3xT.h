@@ -0,0 +1,198 @@
+/*
+    SDP3xT.h - Compile-time specialized interface for SDP31 and SDP32 sensors.
+
+    Copyright (c) 2018 Bryan T. Meyers
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+    and associated documentation files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+    BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SDP3X_T_H
+#define SDP3X_T_H
+
+#include "SDP3x.h"
+#include "SDP3xConvert.h"
+
+namespace SDP3X {
+    /*  The SDP3xT class is an SDP3x with its model, compensation mode and address fixed at
+        compile time
+
+        Command selection and scaling are resolved by the compiler, so the object holds no state
+        at all and conversions to engineering units fold into a constant multiply.
+
+        The bus is a type parameter rather than a TwoWire reference, since TwoWire has no
+        virtual methods to override and drivers such as SoftwareWire do not derive from it. Any
+        type with the Wire methods "beginTransmission", "write(const uint8_t *, size_t)",
+        "endTransmission", "requestFrom(uint8_t, uint8_t)" and "read" can be used, and every
+        call is bound at compile time.
+
+        @param M   - the sensor model (SDP31 or SDP32)
+        @param C   - the Temperature Compensation Mode (Mass Flow or Differential Pressure)
+        @param A   - the Address value for I2C
+        @param Bus - the type of the I2C driver (ie. TwoWire or SoftwareWire)
+        @param W   - the I2C bus the sensor is on (ie. Wire1)
+    */
+    template <Model M, TempCompensation C, uint8_t A, class Bus = TwoWire, Bus &W = Wire>
+    class SDP3xT {
+        static_assert((A == Address1) || (A == Address2) || (A == Address3),
+                      "SDP3xT address must be Address1, Address2 or Address3");
+
+    public:
+        /* Scale factors for this sensor, in units of 1/Pa and 1/C */
+        static constexpr uint8_t PressureScale = (M == SDP31) ? SDP31_DiffScale : SDP32_DiffScale;
+        static constexpr uint8_t TemperatureScale = SDP3X_TempScale;
+        /* Product ID expected from this sensor */
+        static constexpr uint32_t PID = (M == SDP31) ? SDP31_PID : SDP32_PID;
+
+    private:
+        /*  Send a write command
+
+            @param cmd - the two byte command to send
+            @return true iff all ACKs received
+        */
+        static bool writeCommand(const uint8_t cmd[2]) {
+            size_t written;
+            uint8_t status;
+            W.beginTransmission(A);
+            written = W.write(cmd, 2);
+            status  = W.endTransmission();
+            return (status == 0) && (written == 2);
+        }
+
+        /*  Read data back from the device
+
+            @param out   - an array of "words" destinations, NULL entries are not stored
+            @param words - the number of words to read
+            @returns true iff all words read and CRC passed
+        */
+        static bool readData(int16_t *const out[], uint8_t words) {
+            size_t read = W.requestFrom(A, (uint8_t)(words * 3));
+            return SDP3x::checkData(W, out, words, read, true);
+        }
+
+    public:
+        /*  Finish Initializing the sensor object
+
+            Verifies that the sensor at this address is the expected model.
+            @returns true, iff everything went correctly
+        */
+        bool begin() {
+            int16_t info[2];
+            int16_t *const out[2] = { &info[0], &info[1] };
+            if (!writeCommand(ReadInfo1) || !writeCommand(ReadInfo2) || !readData(out, 2)) {
+                return false;
+            }
+            return (((uint32_t)(uint16_t)info[0] << 16) | (uint16_t)info[1]) == PID;
+        }
+
+        /*  Begin taking continuous readings
+
+            @param averaging - average samples until read occurs, otherwise read last value only
+            @returns true, iff everything went correctly
+        */
+        bool startContinuous(bool averaging) {
+            if (C == MassFlow) {
+                return writeCommand(averaging ? StartContMassFlowAvg : StartContMassFlow);
+            }
+            return writeCommand(averaging ? StartContDiffPressureAvg : StartContDiffPressure);
+        }
+
+        /*  Disable continuous measurements
+
+            @returns true, iff everything went correctly
+        */
+        bool stopContinuous() {
+            return writeCommand(StopCont);
+        }
+
+        /*  Start a one-shot reading.
+
+            @param stretching - enable clock stretching
+            @returns true, iff everything went correctly
+        */
+        bool triggerMeasurement(bool stretching) {
+            if (C == MassFlow) {
+                return writeCommand(stretching ? TrigMassFlowStretch : TrigMassFlow);
+            }
+            return writeCommand(stretching ? TrigDiffPressureStretch : TrigDiffPressure);
+        }
+
+        /*  Get a pending reading.
+
+            Both "temp" and "scale" should be left NULL if not used. This will reduce read times.
+            Nothing is stored unless every CRC passes, so a failed read leaves all outputs as-is.
+            @param pressure - a pointer to store the raw pressure value
+            @param temp     - a pointer to store the raw temperature value
+            @param scale    - a pointer to store the pressure scaling factor
+            @returns true, iff everything went correctly
+        */
+        bool readMeasurement(int16_t *pressure, int16_t *temp, int16_t *scale) {
+            int16_t *const out[3] = { pressure, temp, scale };
+            return readData(out, (scale != NULL) ? 3 : ((temp != NULL) ? 2 : 1));
+        }
+
+        /*  Convert a raw pressure value
+
+            @param raw - the raw pressure value
+            @returns the pressure in Pa
+        */
+        static float toPascal(int16_t raw) {
+            return raw * (1.0f / PressureScale);
+        }
+
+        /*  Convert a raw pressure value without floating point
+
+            @param raw - the raw pressure value
+            @returns the pressure in mPa
+        */
+        static int32_t toMilliPascal(int16_t raw) {
+            return (M == SDP31) ? toMilliPascalSDP31(raw) : toMilliPascalSDP32(raw);
+        }
+
+        /*  Convert a raw temperature value
+
+            @param raw - the raw temperature value
+            @returns the temperature in C
+        */
+        static float toCelsius(int16_t raw) {
+            return raw * (1.0f / TemperatureScale);
+        }
+
+        /*  Get the Pressure Scale for this sensor
+
+            @returns scale in units of 1/Pa
+        */
+        static constexpr uint8_t getPressureScale() {
+            return PressureScale;
+        }
+
+        /*  Get the Temperature Scale for this sensor
+
+            @returns scale in units of 1/C
+        */
+        static constexpr uint8_t getTemperatureScale() {
+            return TemperatureScale;
+        }
+    };
+
+    template <Model M, TempCompensation C, uint8_t A, class Bus, Bus &W>
+    constexpr uint8_t SDP3xT<M, C, A, Bus, W>::PressureScale;
+    template <Model M, TempCompensation C, uint8_t A, class Bus, Bus &W>
+    constexpr uint8_t SDP3xT<M, C, A, Bus, W>::TemperatureScale;
+    template <Model M, TempCompensation C, uint8_t A, class Bus, Bus &W>
+    constexpr uint32_t SDP3xT<M, C, A, Bus, W>::PID;
+} // namespace SDP3X
+
+#endif
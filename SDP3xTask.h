@@ -0,0 +1,262 @@
+/*
+    SDP3xTask.h - FreeRTOS acquisition task for SDP3x sensors on ESP32.
+
+    Copyright (c) 2018 Bryan T. Meyers
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+    and associated documentation files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+    BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SDP3X_TASK_H
+#define SDP3X_TASK_H
+
+#include "SDP3x.h"
+
+#if defined(ESP32)
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+namespace SDP3X {
+    /* The most sensors one SDP3xTask can own */
+    const uint8_t TaskMaxSensors = 3;
+    /* Stack size in bytes for an SDP3xTask */
+    const uint32_t TaskStackSize = 2048;
+    /* Length of one RTOS tick in us (portTICK_PERIOD_MS truncates to 0 above a 1kHz tick rate) */
+    const uint32_t TaskTickTime = 1000000UL / configTICK_RATE_HZ;
+
+    /* SDP3xTaskSample is a sample tagged with the sensor it came from */
+    struct SDP3xTaskSample {
+        /* The reading */
+        SDP3xSample sample;
+        /* The index the sensor was given to SDP3xTask */
+        uint8_t sensor;
+    };
+
+    /*  SDP3xTask reads sensors from a task pinned to one core, and queues the samples
+
+        The task owns the bus and every sensor once started, so nothing else may use them until it
+        has stopped. Samples go through a lock-free single-producer/single-consumer queue, with
+        acquire/release ordering so they are safe to drain from a task on the other core. The
+        consumer is notified (ie. xTaskNotifyGive) once every "batch" samples, so it can block in
+        ulTaskNotifyTake instead of polling.
+
+        The task blocks in vTaskDelayUntil between reads, so it never spins and the idle task on
+        its core (and with it the task watchdog) keeps running. The period is therefore rounded to
+        a whole number of RTOS ticks, and is at least one tick (1ms at the usual 1kHz tick rate,
+        which is also ContUpdateTime, ergo no faster rate could return new readings).
+
+        @param N - the number of samples that can be queued, a power of two
+    */
+    template <uint16_t N> class SDP3xTask {
+        static_assert((N > 0) && ((N & (N - 1)) == 0), "SDP3xTask size must be a power of two");
+
+    private:
+        /* Queued samples */
+        SDP3xTaskSample queue[N];
+        /* Free-running count of samples pushed, written by the task only */
+        uint16_t head;
+        /* Free-running count of samples popped, written by the consumer only */
+        uint16_t tail;
+        /* Number of samples dropped because the queue was full */
+        uint32_t dropped;
+        /* The sensors to read, in order */
+        SDP3x *sensors[TaskMaxSensors];
+        /* Number of sensors */
+        uint8_t count;
+        /* Time between reads of every sensor in RTOS ticks */
+        TickType_t period;
+        /* Samples between notifications */
+        uint16_t batch;
+        /* Also read the temperature */
+        bool withTemp;
+        /* True until stop is requested */
+        volatile bool running;
+        /* The acquisition task, NULL if not started */
+        TaskHandle_t handle;
+        /* The task notified when a batch is ready */
+        TaskHandle_t consumer;
+
+        /*  Add a sample, from the acquisition task only
+
+            @param sample - the sample to add, whose "sensor" must already be set
+            @returns true, iff there was room for the sample
+        */
+        bool push(const SDP3xTaskSample &sample) {
+            uint16_t h = this->head;
+            if ((uint16_t)(h - __atomic_load_n(&this->tail, __ATOMIC_ACQUIRE)) >= N) {
+                __atomic_add_fetch(&this->dropped, 1, __ATOMIC_RELAXED);
+                return false;
+            }
+            this->queue[h & (N - 1)] = sample;
+            // Only publish the sample once it has been stored
+            __atomic_store_n(&this->head, (uint16_t)(h + 1), __ATOMIC_RELEASE);
+            return true;
+        }
+
+        /*  Body of the acquisition task
+
+            @param arg - the SDP3xTask that started it
+        */
+        static void run(void *arg) {
+            SDP3xTask *self = (SDP3xTask *)arg;
+            SDP3xTaskSample entry;
+            TickType_t last = xTaskGetTickCount();
+            uint16_t pushed = 0;
+            uint8_t i;
+            while (self->running) {
+                // Block until the next period, counted from the last so jitter does not add up
+                vTaskDelayUntil(&last, self->period);
+                for (i = 0; i < self->count; i++) {
+                    entry.sensor = i;
+                    if (self->sensors[i]->readSample(&entry.sample, self->withTemp) &&
+                        self->push(entry) && (++pushed >= self->batch)) {
+                        xTaskNotifyGive(self->consumer);
+                        pushed = 0;
+                    }
+                }
+            }
+            self->handle = NULL;
+            vTaskDelete(NULL);
+        }
+
+    public:
+        /*  Constructor
+
+            @param sensors  - an array of "count" sensors, which must outlive the task
+            @param count    - the number of sensors, at most TaskMaxSensors
+            @param periodUs - the time between reads of every sensor in us, rounded to the nearest
+                              RTOS tick and at least one tick
+            @param batch    - the number of samples between notifications
+            @param withTemp - also read the temperature, otherwise only the pressure is read
+            @returns a new SDP3xTask, not yet started
+        */
+        SDP3xTask(SDP3x *const sensors[], uint8_t count, uint32_t periodUs, uint16_t batch,
+                  bool withTemp) {
+            uint8_t i;
+            this->count = (count > TaskMaxSensors) ? TaskMaxSensors : count;
+            for (i = 0; i < this->count; i++) {
+                this->sensors[i] = sensors[i];
+            }
+            this->head     = 0;
+            this->tail     = 0;
+            this->dropped  = 0;
+            this->period   = (TickType_t)((periodUs + TaskTickTime / 2) / TaskTickTime);
+            if (this->period == 0) {
+                this->period = 1;
+            }
+            this->batch    = (batch == 0) ? 1 : batch;
+            this->withTemp = withTemp;
+            this->running  = false;
+            this->handle   = NULL;
+            this->consumer = NULL;
+        }
+
+        /*  Start the acquisition task
+
+            The sensors must already be started (ie. in continuous mode).
+            @param core     - the core to pin the task to
+            @param priority - the priority of the task
+            @param consumer - the task to notify, NULL for the calling task
+            @returns true, iff the task was created
+        */
+        bool start(BaseType_t core, UBaseType_t priority, TaskHandle_t consumer) {
+            if (this->handle != NULL) {
+                return false;
+            }
+            this->consumer = (consumer != NULL) ? consumer : xTaskGetCurrentTaskHandle();
+            this->running  = true;
+            if (xTaskCreatePinnedToCore(run, "SDP3x", TaskStackSize, this, priority, &this->handle,
+                                        core) != pdPASS) {
+                this->running = false;
+                this->handle  = NULL;
+                return false;
+            }
+            return true;
+        }
+
+        /*  Ask the acquisition task to stop after its current period
+         */
+        void stop() {
+            this->running = false;
+        }
+
+        /*  Get the time between reads actually used, after rounding to RTOS ticks
+
+            @returns the period in us
+        */
+        uint32_t getPeriod() {
+            return (uint32_t)this->period * TaskTickTime;
+        }
+
+        /*  Check if the acquisition task still exists
+
+            @returns true, iff the task has not yet exited
+        */
+        bool isRunning() {
+            return this->handle != NULL;
+        }
+
+        /*  Remove the oldest sample, from the consumer only
+
+            @param sample - a pointer to store the sample
+            @returns true, iff a sample was available
+        */
+        bool pop(SDP3xTaskSample *sample) {
+            return drain(sample, 1) == 1;
+        }
+
+        /*  Remove up to "max" of the oldest samples, from the consumer only
+
+            @param samples - an array of at least "max" samples
+            @param max     - the most samples to remove
+            @returns the number of samples removed
+        */
+        uint16_t drain(SDP3xTaskSample *samples, uint16_t max) {
+            uint16_t t     = this->tail;
+            uint16_t count = __atomic_load_n(&this->head, __ATOMIC_ACQUIRE) - t;
+            uint16_t i;
+            if (count > max) {
+                count = max;
+            }
+            for (i = 0; i < count; i++, t++) {
+                samples[i] = this->queue[t & (N - 1)];
+            }
+            // Only release the slots once they have been copied out
+            __atomic_store_n(&this->tail, t, __ATOMIC_RELEASE);
+            return count;
+        }
+
+        /*  Get the number of samples waiting to be drained
+
+            @returns the number of samples queued
+        */
+        uint16_t available() {
+            return __atomic_load_n(&this->head, __ATOMIC_ACQUIRE) - this->tail;
+        }
+
+        /*  Get the number of samples lost because the queue was full
+
+            @returns the number of dropped samples
+        */
+        uint32_t overruns() {
+            return __atomic_load_n(&this->dropped, __ATOMIC_RELAXED);
+        }
+    };
+} // namespace SDP3X
+
+#endif
+
+#endif
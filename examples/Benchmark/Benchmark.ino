@@ -0,0 +1,205 @@
+/*
+    Benchmark.ino - Measure the achievable sample rate of an SDP3x sensor in each mode.
+
+    Every combination of I2C clock, word count and measurement mode is sampled in turn, and one
+    CSV line is printed per combination:
+
+        mode,clock,words,samples,errors,crc_errors,rate,p50,p90,p99,max
+
+    "errors" counts every failed sample (NACK, short read, bad CRC or poll timeout), and
+    "crc_errors" only those with a bad CRC, which needs SDP3X_STATS defined for the whole build
+    (otherwise it is "-"). "rate" is in samples per second, and the percentiles are per-sample
+    latencies in us.
+*/
+
+#include <SDP3x.h>
+
+using namespace SDP3X;
+
+/* The number of samples to take for each combination, enough for p99 to differ from max */
+const uint16_t Samples = 200;
+
+/* The longest a deferred read may keep polling before it counts as an error, in us */
+const unsigned long PollTimeout = (TrigSettleTime + 10) * 1000UL;
+
+/* The I2C clock rates to sweep */
+const uint32_t Clocks[] = { 100000, 400000, 1000000 };
+
+/* The measurement modes to sweep */
+enum Mode { Continuous, ContinuousAveraging, TriggeredStretching, TriggeredPolling };
+const char *const ModeNames[] = { "cont", "cont_avg", "trig_stretch", "trig_poll" };
+
+SDP3x sensor(Address1, DiffPressure);
+
+/* Per-sample latencies for the current combination */
+uint16_t latency[Samples];
+
+/* The result of the last deferred read */
+bool polled;
+
+/*  Called when a deferred read completes
+
+    @param success - true iff all words were read and CRC passed
+*/
+void onRead(SDP3x *, bool success) {
+    polled = success;
+}
+
+/*  Take a single sample
+
+    @param mode  - the measurement mode in use
+    @param words - the number of words to read (1, 2 or 3)
+    @returns true, iff everything went correctly
+*/
+bool sample(Mode mode, uint8_t words) {
+    int16_t pressure;
+    int16_t temp;
+    int16_t scale;
+    int16_t *t = (words >= 2) ? &temp : NULL;
+    int16_t *s = (words >= 3) ? &scale : NULL;
+    unsigned long start;
+    switch (mode) {
+    case TriggeredStretching:
+        if (!sensor.triggerMeasurement(true)) {
+            return false;
+        }
+        return sensor.readMeasurement(&pressure, t, s);
+    case TriggeredPolling:
+        if (!sensor.triggerMeasurement(false)) {
+            return false;
+        }
+        // Only a NACK leaves the read pending, so this stops on success or on a bad read
+        sensor.beginRead(&pressure, t, s, onRead);
+        start = micros();
+        while (!sensor.poll()) {
+            if (micros() - start > PollTimeout) {
+                // The sensor stopped answering, so give up rather than stall the sweep
+                sensor.cancelRead();
+                return false;
+            }
+        }
+        return polled;
+    default:
+        return sensor.readMeasurement(&pressure, t, s);
+    }
+}
+
+/*  Sort the latencies in place
+
+    Insertion sort is plenty for a few hundred values, and needs no extra memory.
+*/
+void sortLatency() {
+    uint16_t i;
+    uint16_t j;
+    uint16_t value;
+    for (i = 1; i < Samples; i++) {
+        value = latency[i];
+        for (j = i; (j > 0) && (latency[j - 1] > value); j--) {
+            latency[j] = latency[j - 1];
+        }
+        latency[j] = value;
+    }
+}
+
+/*  Get a percentile of the sorted latencies, by the nearest-rank method
+
+    @param percent - the percentile, from 1 to 100
+    @returns the smallest latency with at least "percent" % of samples at or below it
+*/
+uint16_t percentile(uint8_t percent) {
+    return latency[((uint32_t)Samples * percent + 99) / 100 - 1];
+}
+
+/*  Run and report a single combination
+
+    @param mode  - the measurement mode to use
+    @param clock - the I2C clock rate
+    @param words - the number of words to read (1, 2 or 3)
+*/
+void run(Mode mode, uint32_t clock, uint8_t words) {
+    uint16_t errors = 0;
+    uint16_t i;
+    unsigned long begin;
+    unsigned long start;
+    unsigned long elapsed;
+
+    Wire.setClock(clock);
+    sensor.stopContinuous();
+    // The sensor needs time to stop before accepting a new command
+    delay(ContStopTime);
+    if (mode == Continuous) {
+        sensor.startContinuous(false);
+    } else if (mode == ContinuousAveraging) {
+        sensor.startContinuous(true);
+    }
+    // Allow the first continuous sample to become available
+    delay(ContStartTime);
+#ifdef SDP3X_STATS
+    sensor.resetStats();
+#endif
+
+    begin = micros();
+    for (i = 0; i < Samples; i++) {
+        start = micros();
+        if (!sample(mode, words)) {
+            errors++;
+        }
+        elapsed    = micros() - start;
+        latency[i] = (elapsed > 0xFFFF) ? 0xFFFF : elapsed;
+    }
+    elapsed = micros() - begin;
+    sortLatency();
+
+    Serial.print(ModeNames[mode]);
+    Serial.print(',');
+    Serial.print(clock);
+    Serial.print(',');
+    Serial.print(words);
+    Serial.print(',');
+    Serial.print(Samples);
+    Serial.print(',');
+    Serial.print(errors);
+    Serial.print(',');
+#ifdef SDP3X_STATS
+    Serial.print(sensor.getStats().crcFailures);
+#else
+    Serial.print('-');
+#endif
+    Serial.print(',');
+    Serial.print((float)Samples * 1000000.0f / elapsed, 1);
+    Serial.print(',');
+    Serial.print(percentile(50));
+    Serial.print(',');
+    Serial.print(percentile(90));
+    Serial.print(',');
+    Serial.print(percentile(99));
+    Serial.print(',');
+    Serial.println(latency[Samples - 1]);
+}
+
+void setup() {
+    uint8_t c;
+    uint8_t w;
+    uint8_t m;
+    Serial.begin(115200);
+    while (!Serial) {
+    }
+    Wire.begin();
+    if (!sensor.begin()) {
+        Serial.println("# sensor not found");
+        return;
+    }
+    Serial.println("mode,clock,words,samples,errors,crc_errors,rate,p50,p90,p99,max");
+    for (m = Continuous; m <= TriggeredPolling; m++) {
+        for (c = 0; c < sizeof(Clocks) / sizeof(Clocks[0]); c++) {
+            for (w = 1; w <= 3; w++) {
+                run((Mode)m, Clocks[c], w);
+            }
+        }
+    }
+    sensor.stopContinuous();
+    Serial.println("# done");
+}
+
+void loop() {
+}
@@ -0,0 +1,94 @@
+/*
+    DecodeBench.cpp - Times the SDP3x decode path on a zero-latency simulated bus.
+
+    Copyright (c) 2018 Bryan T. Meyers
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+    and associated documentation files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+    BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "SDP3xConvert.h"
+#include "SDP3xSim.h"
+#include "SDP3xT.h"
+
+#include <chrono>
+#include <stdio.h>
+
+using namespace SDP3X;
+
+/* The number of calls to time for each case */
+const uint32_t Iterations = 1000000;
+
+/* Volatile output, so that no call can be folded away */
+volatile int32_t output;
+
+SDP3xSim sim(Address1, SDP31, 1);
+SDP3x sensor(Address1, DiffPressure);
+SDP3xT<SDP31, DiffPressure, Address1> fixed;
+
+/*  Time a case and print its CSV line
+
+    @param name - the case
+    @param body - the code to time, run "Iterations" times
+*/
+template <class Body> void run(const char *name, Body body) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    uint32_t i;
+    for (i = 0; i < Iterations; i++) {
+        body();
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    printf("%s,%.1f\n", name, elapsed.count() / Iterations);
+}
+
+int main() {
+    Wire.attach(&sim);
+    Wire.setClock(0);
+    Wire.begin();
+    sim.setPressure(1234);
+    sim.setTemperature(5000);
+    sensor.begin();
+    sensor.startContinuous(false);
+    delay(ContStartTime);
+
+    printf("case,ns_per_call\n");
+    run("readMeasurement_1", []() {
+        int16_t p = 0;
+        sensor.readMeasurement(&p, NULL, NULL);
+        output = p;
+    });
+    run("readMeasurement_2", []() {
+        int16_t p = 0;
+        int16_t t = 0;
+        sensor.readMeasurement(&p, &t, NULL);
+        output = p + t;
+    });
+    run("readMeasurement_3", []() {
+        int16_t p = 0;
+        int16_t t = 0;
+        int16_t s = 0;
+        sensor.readMeasurement(&p, &t, &s);
+        output = p + t + s;
+    });
+    run("SDP3xT_readMeasurement_1", []() {
+        int16_t p = 0;
+        fixed.readMeasurement(&p, NULL, NULL);
+        output = p;
+    });
+    run("crc8_word", []() { output = crc8(crc8(0xFF, (uint8_t)output), 0x5A); });
+    run("toMilliPascalSDP31", []() { output = toMilliPascalSDP31((int16_t)output); });
+    run("toMilliPascal", []() { output = toMilliPascal((int16_t)output, 60); });
+    return 0;
+}
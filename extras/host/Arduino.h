@@ -0,0 +1,90 @@
+/*
+    Arduino.h - Minimal Arduino core for building the SDP3x library on a host.
+
+    Copyright (c) 2018 Bryan T. Meyers
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+    and associated documentation files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+    BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SDP3X_HOST_ARDUINO_H
+#define SDP3X_HOST_ARDUINO_H
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define LOW 0
+#define HIGH 1
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+/* Pins used by the host Wire bus */
+#define SDA 18
+#define SCL 19
+
+/* Flash and RAM are the same on a host */
+#define PROGMEM
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+
+/* The host clock is reported as 16MHz, as on most AVR boards */
+#define F_CPU 16000000UL
+#define clockCyclesPerMicrosecond() (F_CPU / 1000000UL)
+
+/*  Time
+
+    The host clock is simulated, so runs are repeatable and never wait on the workstation. It only
+    moves forward through delay, delayMicroseconds, bus transfers (see TwoWire::setClock) and
+    hostAdvance. Every call to micros or millis also advances it by 1us, so that busy-waits on the
+    clock always finish.
+*/
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+/*  Move the simulated clock forward
+
+    @param us - the time to skip in us
+*/
+void hostAdvance(uint32_t us);
+
+/*  Get the simulated clock without advancing it
+
+    @returns the time since start in us
+*/
+uint64_t hostTime();
+
+/*  Digital pins
+
+    Pins read HIGH (pulled up) unless driven LOW as an OUTPUT. SDA may be held low by a simulated
+    device, see TwoWire::holdSDA.
+*/
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+
+/* There is only one context on a host */
+inline void noInterrupts() {
+}
+inline void interrupts() {
+}
+
+#endif
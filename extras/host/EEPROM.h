@@ -0,0 +1,62 @@
+/*
+    EEPROM.h - Simulated EEPROM for building the SDP3x library on a host.
+
+    Copyright (c) 2018 Bryan T. Meyers
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+    and associated documentation files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+    BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SDP3X_HOST_EEPROM_H
+#define SDP3X_HOST_EEPROM_H
+
+#include <Arduino.h>
+
+/* The size of the simulated EEPROM in bytes, as on an ATmega328P */
+const uint16_t HostEEPROMSize = 1024;
+
+/* EEPROMClass is a RAM copy of an erased EEPROM, with the ESP32 style begin/commit accepted */
+class EEPROMClass {
+private:
+    /* The contents */
+    uint8_t data[HostEEPROMSize];
+
+public:
+    EEPROMClass() {
+        memset(this->data, 0xFF, sizeof(this->data));
+    }
+    bool begin(size_t size) {
+        return size <= HostEEPROMSize;
+    }
+    bool commit() {
+        return true;
+    }
+    uint8_t read(int addr) {
+        return this->data[addr];
+    }
+    void write(int addr, uint8_t value) {
+        this->data[addr] = value;
+    }
+    void update(int addr, uint8_t value) {
+        this->data[addr] = value;
+    }
+    uint16_t length() {
+        return HostEEPROMSize;
+    }
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
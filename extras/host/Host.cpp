@@ -0,0 +1,338 @@
+/*
+    Host.cpp - Simulated clock, pins, I2C bus and EEPROM for host builds.
+
+    Copyright (c) 2018 Bryan T. Meyers
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+    and associated documentation files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+    BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <Wire.h>
+
+/* The simulated clock in us */
+static uint64_t now = 0;
+
+/* Pin modes and output values */
+static uint8_t modes[256];
+static uint8_t values[256];
+
+TwoWire Wire;
+TwoWire Wire1;
+EEPROMClass EEPROM;
+
+unsigned long millis() {
+    now++;
+    return (unsigned long)(now / 1000);
+}
+
+unsigned long micros() {
+    now++;
+    return (unsigned long)now;
+}
+
+void delay(unsigned long ms) {
+    now += (uint64_t)ms * 1000;
+}
+
+void delayMicroseconds(unsigned int us) {
+    now += us;
+}
+
+void hostAdvance(uint32_t us) {
+    now += us;
+}
+
+uint64_t hostTime() {
+    return now;
+}
+
+/*  Get the level a pin drives onto its line
+
+    @param pin - the pin
+    @returns LOW iff the pin is an output driven low
+*/
+static uint8_t level(uint8_t pin) {
+    return ((modes[pin] == OUTPUT) && (values[pin] == LOW)) ? LOW : HIGH;
+}
+
+/*  Update a pin, counting SCL pulses on the Wire bus
+
+    While the bus hardware is enabled it owns SDA and SCL, as on AVR, so changes have no effect.
+    @param pin   - the pin
+    @param mode  - the new mode
+    @param value - the new output value
+*/
+static void update(uint8_t pin, uint8_t mode, uint8_t value) {
+    uint8_t before;
+    if (((pin == SDA) || (pin == SCL)) && Wire.isEnabled()) {
+        return;
+    }
+    before       = level(pin);
+    modes[pin]   = mode;
+    values[pin]  = value;
+    // A device only clocks out a bit when SCL rises
+    if ((pin == SCL) && (before == LOW) && (level(pin) == HIGH)) {
+        Wire.pulseSCL();
+    }
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    // As on AVR, an input with pull-up becomes an output driven high
+    update(pin, mode, (mode == INPUT_PULLUP) ? HIGH : values[pin]);
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+    update(pin, modes[pin], value);
+}
+
+int digitalRead(uint8_t pin) {
+    if ((pin == SDA) && Wire.isSDAHeld()) {
+        return LOW;
+    }
+    return level(pin);
+}
+
+TwoWire::TwoWire() {
+    this->count        = 0;
+    this->txAddress    = 0;
+    this->txLength     = 0;
+    this->rxLength     = 0;
+    this->rxPosition   = 0;
+    this->rxDone       = 0;
+    this->clock        = 100000;
+    this->enabled      = false;
+    this->timeout      = 0;
+    this->timedOut     = false;
+    this->held         = 0;
+    this->transactions = 0;
+    this->bytes        = 0;
+}
+
+HostI2CDevice *TwoWire::find(uint8_t address) {
+    uint8_t i;
+    for (i = 0; i < this->count; i++) {
+        if ((this->devices[i]->getAddress() == address) && this->devices[i]->isPresent()) {
+            return this->devices[i];
+        }
+    }
+    return NULL;
+}
+
+void TwoWire::transfer(uint8_t length) {
+    this->transactions++;
+    this->bytes += length;
+    if (this->clock != 0) {
+        // Start, address, data and stop, 9 clocks per byte including the ACK
+        now += ((uint64_t)(length + 1) * 9 + 2) * 1000000 / this->clock;
+    }
+}
+
+bool TwoWire::hung() {
+    if (this->held == 0) {
+        return false;
+    }
+    this->transactions++;
+    if (this->timeout != 0) {
+        now += this->timeout;
+        this->timedOut = true;
+    } else {
+        // Real hardware would never return, which no test could survive
+        now += 1000000;
+    }
+    return true;
+}
+
+void TwoWire::begin() {
+    this->enabled = true;
+}
+
+void TwoWire::end() {
+    this->enabled = false;
+}
+
+void TwoWire::setClock(uint32_t clock) {
+    this->clock = clock;
+}
+
+void TwoWire::beginTransmission(uint8_t address) {
+    this->txAddress = address;
+    this->txLength  = 0;
+}
+
+size_t TwoWire::write(uint8_t data) {
+    if (this->txLength >= HostWireBufferSize) {
+        return 0;
+    }
+    this->txBuffer[this->txLength++] = data;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t length) {
+    size_t i;
+    for (i = 0; i < length; i++) {
+        if (write(data[i]) == 0) {
+            break;
+        }
+    }
+    return i;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+    HostI2CDevice *device;
+    bool acked = false;
+    uint8_t i;
+    (void)sendStop;
+    if (!this->enabled) {
+        return 4;
+    }
+    if (hung()) {
+        return (this->timeout != 0) ? 5 : 4;
+    }
+    transfer(this->txLength);
+    if (this->txAddress == 0) {
+        for (i = 0; i < this->count; i++) {
+            if (this->devices[i]->isPresent()) {
+                this->devices[i]->generalCall(this->txBuffer, this->txLength);
+                acked = true;
+            }
+        }
+        return acked ? 0 : 2;
+    }
+    device = find(this->txAddress);
+    if (device == NULL) {
+        return 2;
+    }
+    return device->receive(this->txBuffer, this->txLength) ? 0 : 3;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity, uint8_t sendStop) {
+    HostI2CDevice *device;
+    uint32_t stretch;
+    (void)sendStop;
+    this->rxLength   = 0;
+    this->rxPosition = 0;
+    if (!this->enabled || (quantity > HostWireBufferSize) || hung()) {
+        return 0;
+    }
+    device = find(address);
+    if (device == NULL) {
+        transfer(0);
+        return 0;
+    }
+    stretch = device->getStretch();
+    if ((this->timeout != 0) && (stretch > this->timeout)) {
+        now += this->timeout;
+        this->timedOut = true;
+        this->transactions++;
+        return 0;
+    }
+    now += stretch;
+    this->rxLength = device->transmit(this->rxBuffer, quantity);
+    transfer(this->rxLength);
+    return this->rxLength;
+}
+
+void TwoWire::sendRequest(uint8_t address, size_t length) {
+    uint64_t start = now;
+    requestFrom(address, (uint8_t)length);
+    // Run the transfer now, but give the time it took back until it would have finished
+    this->rxDone = now;
+    now          = start;
+}
+
+uint8_t TwoWire::done() {
+    // Like micros(), so that a busy-wait on the bus still sees it finish
+    now++;
+    return (now >= this->rxDone) ? 1 : 0;
+}
+
+int TwoWire::available() {
+    if (now < this->rxDone) {
+        return 0;
+    }
+    return this->rxLength - this->rxPosition;
+}
+
+int TwoWire::read() {
+    if (this->rxPosition >= this->rxLength) {
+        return -1;
+    }
+    return this->rxBuffer[this->rxPosition++];
+}
+
+int TwoWire::peek() {
+    if (this->rxPosition >= this->rxLength) {
+        return -1;
+    }
+    return this->rxBuffer[this->rxPosition];
+}
+
+void TwoWire::setWireTimeout(uint32_t timeout, bool reset) {
+    (void)reset;
+    this->timeout = timeout;
+}
+
+bool TwoWire::getWireTimeoutFlag() {
+    return this->timedOut;
+}
+
+void TwoWire::clearWireTimeoutFlag() {
+    this->timedOut = false;
+}
+
+bool TwoWire::attach(HostI2CDevice *device) {
+    if (this->count >= HostWireMaxDevices) {
+        return false;
+    }
+    this->devices[this->count++] = device;
+    return true;
+}
+
+void TwoWire::detachAll() {
+    this->count = 0;
+}
+
+bool TwoWire::isEnabled() {
+    return this->enabled;
+}
+
+void TwoWire::holdSDA(uint8_t pulses) {
+    this->held = pulses;
+}
+
+bool TwoWire::isSDAHeld() {
+    return this->held != 0;
+}
+
+void TwoWire::pulseSCL() {
+    if (this->held != 0) {
+        this->held--;
+    }
+}
+
+uint32_t TwoWire::getTransactions() {
+    return this->transactions;
+}
+
+uint32_t TwoWire::getBytes() {
+    return this->bytes;
+}
+
+void TwoWire::resetCounters() {
+    this->transactions = 0;
+    this->bytes        = 0;
+}
@@ -0,0 +1,210 @@
+/*
+    SDP3xSim.cpp - Simulated SDP31/SDP32 sensor for host builds.
+
+    Copyright (c) 2018 Bryan T. Meyers
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+    and associated documentation files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+    BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "SDP3xSim.h"
+
+using namespace SDP3X;
+
+/*  Check a received command
+
+    @param data - the received bytes
+    @param cmd  - the command to compare with
+    @returns true, iff the bytes are the command
+*/
+static bool is(const uint8_t *data, const uint8_t cmd[2]) {
+    return (data[0] == cmd[0]) && (data[1] == cmd[1]);
+}
+
+SDP3xSim::SDP3xSim(uint8_t address, Model model, uint64_t serial) {
+    this->address  = address;
+    this->model    = model;
+    this->serial   = serial;
+    this->pressure = 0;
+    this->temp     = 0;
+    this->badWord  = 0;
+    this->badReads = 0;
+    this->present  = true;
+    this->commands = 0;
+    this->rejected = 0;
+    powerCycle();
+}
+
+void SDP3xSim::put(uint8_t *data, uint16_t value, uint8_t index) {
+    data[0] = (uint8_t)(value >> 8);
+    data[1] = (uint8_t)value;
+    data[2] = crc8(crc8(0xFF, data[0]), data[1]);
+    if ((this->badReads != 0) && (this->badWord == index)) {
+        data[2] ^= 0x01;
+    }
+}
+
+void SDP3xSim::setPressure(int16_t pressure) {
+    this->pressure = pressure;
+}
+
+void SDP3xSim::setTemperature(int16_t temp) {
+    this->temp = temp;
+}
+
+void SDP3xSim::injectCRCError(uint8_t word, uint8_t reads) {
+    this->badWord  = word;
+    this->badReads = reads;
+}
+
+void SDP3xSim::setPresent(bool present) {
+    this->present = present;
+}
+
+void SDP3xSim::powerCycle() {
+    this->state      = SimIdle;
+    this->averaging  = false;
+    this->stretching = false;
+    this->info1      = false;
+    this->ready      = 0;
+    this->busy       = 0;
+}
+
+SDP3xSimState SDP3xSim::getState() {
+    return this->state;
+}
+
+bool SDP3xSim::isAveraging() {
+    return this->averaging;
+}
+
+uint32_t SDP3xSim::getCommands() {
+    return this->commands;
+}
+
+uint32_t SDP3xSim::getRejected() {
+    return this->rejected;
+}
+
+uint8_t SDP3xSim::getAddress() {
+    return this->address;
+}
+
+bool SDP3xSim::isPresent() {
+    return this->present;
+}
+
+bool SDP3xSim::receive(const uint8_t *data, uint8_t length) {
+    uint64_t now = hostTime();
+    bool info1   = this->info1;
+    if (length == 0) {
+        // Address-only probe
+        return true;
+    }
+    this->commands++;
+    this->info1 = false;
+    if ((length != 2) || (now < this->busy)) {
+        this->rejected++;
+        return false;
+    }
+    if (this->state == SimContinuous) {
+        // Continuous mode only accepts the command to stop it
+        if (!is(data, StopCont)) {
+            this->rejected++;
+            return false;
+        }
+        this->state = SimIdle;
+        this->busy  = now + ContStopTime * 1000UL;
+        return true;
+    }
+    if (is(data, StartContMassFlowAvg) || is(data, StartContDiffPressureAvg) ||
+        is(data, StartContMassFlow) || is(data, StartContDiffPressure)) {
+        this->state     = SimContinuous;
+        this->averaging = is(data, StartContMassFlowAvg) || is(data, StartContDiffPressureAvg);
+        this->ready     = now + ContStartTime * 1000UL;
+    } else if (is(data, TrigMassFlow) || is(data, TrigDiffPressure) ||
+               is(data, TrigMassFlowStretch) || is(data, TrigDiffPressureStretch)) {
+        this->state      = SimTriggered;
+        this->stretching = is(data, TrigMassFlowStretch) || is(data, TrigDiffPressureStretch);
+        this->ready      = now + TrigSettleTime * 1000UL;
+    } else if (is(data, ReadInfo1)) {
+        this->info1 = true;
+    } else if (is(data, ReadInfo2) && info1) {
+        this->state = SimInfo;
+    } else if (!is(data, StopCont)) {
+        this->rejected++;
+        return false;
+    }
+    return true;
+}
+
+uint32_t SDP3xSim::getStretch() {
+    uint64_t now = hostTime();
+    if ((this->state == SimTriggered) && this->stretching && (now < this->ready)) {
+        return (uint32_t)(this->ready - now);
+    }
+    return 0;
+}
+
+uint8_t SDP3xSim::transmit(uint8_t *data, uint8_t length) {
+    uint16_t words[6];
+    uint8_t count;
+    uint8_t i;
+    switch (this->state) {
+    case SimContinuous:
+    case SimTriggered:
+        if (hostTime() < this->ready) {
+            return 0;
+        }
+        words[0] = (uint16_t)this->pressure;
+        words[1] = (uint16_t)this->temp;
+        words[2] = (this->model == SDP31) ? SDP31_DiffScale : SDP32_DiffScale;
+        count    = 3;
+        if (this->state == SimTriggered) {
+            // A one-shot reading can only be read once
+            this->state = SimIdle;
+        }
+        break;
+    case SimInfo:
+        words[0]    = (uint16_t)(((this->model == SDP31) ? SDP31_PID : SDP32_PID) >> 16);
+        words[1]    = (uint16_t)((this->model == SDP31) ? SDP31_PID : SDP32_PID);
+        words[2]    = (uint16_t)(this->serial >> 48);
+        words[3]    = (uint16_t)(this->serial >> 32);
+        words[4]    = (uint16_t)(this->serial >> 16);
+        words[5]    = (uint16_t)this->serial;
+        count       = 6;
+        this->state = SimIdle;
+        break;
+    default:
+        return 0;
+    }
+    // The master may stop early, but never gets more than the sensor has
+    if (length > count * 3) {
+        length = count * 3;
+    }
+    for (i = 0; i < length / 3; i++) {
+        put(&data[i * 3], words[i], i);
+    }
+    if (this->badReads != 0) {
+        this->badReads--;
+    }
+    return (length / 3) * 3;
+}
+
+void SDP3xSim::generalCall(const uint8_t *data, uint8_t length) {
+    if ((length == 1) && (data[0] == SoftReset[1])) {
+        powerCycle();
+    }
+}
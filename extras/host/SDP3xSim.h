@@ -0,0 +1,133 @@
+/*
+    SDP3xSim.h - Simulated SDP31/SDP32 sensor for host builds.
+
+    Copyright (c) 2018 Bryan T. Meyers
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+    and associated documentation files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+    BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SDP3X_SIM_H
+#define SDP3X_SIM_H
+
+#include "SDP3x.h"
+
+/* What a simulated sensor is doing */
+enum SDP3xSimState { SimIdle, SimContinuous, SimTriggered, SimInfo };
+
+/*  SDP3xSim emulates an SDP31 or SDP32 on a host Wire bus
+
+    It follows the command set in SDP3x.h: product ID and serial number, continuous mode (which
+    rejects every command but StopCont), and triggered measurements with or without clock
+    stretching, with the timing given by the SDP3X timing constants. Measurements return the
+    pressure and temperature set by the test, and CRC errors or disconnection can be injected.
+*/
+class SDP3xSim : public HostI2CDevice {
+private:
+    /* The address, model and serial number */
+    uint8_t address;
+    SDP3X::Model model;
+    uint64_t serial;
+    /* The current state */
+    SDP3xSimState state;
+    /* True iff continuous mode is averaging */
+    bool averaging;
+    /* True iff the triggered measurement stretches the clock */
+    bool stretching;
+    /* True iff ReadInfo1 was the last command */
+    bool info1;
+    /* Time in us at which the measurement is ready */
+    uint64_t ready;
+    /* Time in us before which every command is rejected */
+    uint64_t busy;
+    /* The raw values measured */
+    int16_t pressure;
+    int16_t temp;
+    /* Word whose CRC is corrupted, and for how many more reads */
+    uint8_t badWord;
+    uint8_t badReads;
+    /* True iff the sensor answers its address */
+    bool present;
+    /* Counters */
+    uint32_t commands;
+    uint32_t rejected;
+
+    /*  Store one word and its CRC
+
+        @param data  - where to store the 3 bytes
+        @param value - the word
+        @param index - the position of the word in the read
+    */
+    void put(uint8_t *data, uint16_t value, uint8_t index);
+
+public:
+    /*  Constructor
+
+        @param address - the Address value for I2C
+        @param model   - the model to emulate
+        @param serial  - the manufacturer serial number to report
+        @returns a new, idle, powered sensor
+    */
+    SDP3xSim(uint8_t address, SDP3X::Model model, uint64_t serial);
+
+    /* Set the raw values the next measurements return */
+    void setPressure(int16_t pressure);
+    void setTemperature(int16_t temp);
+
+    /*  Corrupt the CRC of one word in the next reads
+
+        @param word  - the position of the word in the read (0 pressure, 1 temp, 2 scale)
+        @param reads - the number of reads to corrupt
+    */
+    void injectCRCError(uint8_t word, uint8_t reads);
+
+    /*  Connect or disconnect the sensor, keeping its state as if it stayed powered
+
+        @param present - true iff the sensor answers its address
+    */
+    void setPresent(bool present);
+
+    /*  Lose power and start again, idle
+     */
+    void powerCycle();
+
+    /*  Get what the sensor is doing
+
+        @returns the current state
+    */
+    SDP3xSimState getState();
+
+    /*  Check the continuous mode in use
+
+        @returns true, iff continuous mode was started with averaging
+    */
+    bool isAveraging();
+
+    /*  Get the number of commands received, and of those rejected
+
+        @returns the count since construction
+    */
+    uint32_t getCommands();
+    uint32_t getRejected();
+
+    uint8_t getAddress();
+    bool isPresent();
+    bool receive(const uint8_t *data, uint8_t length);
+    uint32_t getStretch();
+    uint8_t transmit(uint8_t *data, uint8_t length);
+    void generalCall(const uint8_t *data, uint8_t length);
+};
+
+#endif
@@ -0,0 +1,224 @@
+/*
+    Wire.h - Simulated I2C bus for building the SDP3x library on a host.
+
+    Copyright (c) 2018 Bryan T. Meyers
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+    and associated documentation files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+    BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SDP3X_HOST_WIRE_H
+#define SDP3X_HOST_WIRE_H
+
+#include <Arduino.h>
+
+/* Same as AVR Wire since 1.8.2, which supports setWireTimeout */
+#define WIRE_HAS_TIMEOUT
+
+/* The most bytes in one transaction, as for AVR Wire */
+const uint8_t HostWireBufferSize = 32;
+/* The most devices on one simulated bus */
+const uint8_t HostWireMaxDevices = 8;
+
+/*  HostI2CDevice is a simulated device that can be attached to a TwoWire bus
+
+    Every transaction is delivered whole, once the master has finished it.
+*/
+class HostI2CDevice {
+public:
+    virtual ~HostI2CDevice() {
+    }
+
+    /*  Get the address of this device
+
+        @returns the 7-bit address
+    */
+    virtual uint8_t getAddress() = 0;
+
+    /*  Check if this device acknowledges its address
+
+        @returns true, iff the device is connected and powered
+    */
+    virtual bool isPresent() = 0;
+
+    /*  Receive a write transaction
+
+        @param data   - the bytes written, after the address
+        @param length - the number of bytes, 0 for an address-only probe
+        @returns true, iff every byte was acknowledged
+    */
+    virtual bool receive(const uint8_t *data, uint8_t length) = 0;
+
+    /*  Get how long the device will stretch the clock before answering a read
+
+        @returns the time in us, 0 if it answers at once
+    */
+    virtual uint32_t getStretch() = 0;
+
+    /*  Answer a read transaction
+
+        @param data   - the bytes to send
+        @param length - the number of bytes the master asked for
+        @returns the number of bytes sent, 0 if the read was not acknowledged
+    */
+    virtual uint8_t transmit(uint8_t *data, uint8_t length) = 0;
+
+    /*  Receive a general call (address 0)
+
+        @param data   - the bytes written
+        @param length - the number of bytes
+    */
+    virtual void generalCall(const uint8_t *data, uint8_t length) = 0;
+};
+
+/*  TwoWire is the Arduino Wire API on a simulated bus
+
+    Transfers take as long as they would at the configured clock, and a clock of 0 makes the bus
+    take no time at all (ie. for benchmarks). Transactions and bytes are counted, so tests can
+    check the traffic an API call makes.
+*/
+class TwoWire {
+private:
+    /* The attached devices */
+    HostI2CDevice *devices[HostWireMaxDevices];
+    uint8_t count;
+    /* The pending write */
+    uint8_t txAddress;
+    uint8_t txBuffer[HostWireBufferSize];
+    uint8_t txLength;
+    /* The last read */
+    uint8_t rxBuffer[HostWireBufferSize];
+    uint8_t rxLength;
+    uint8_t rxPosition;
+    /* The time in us the last read finishes, later than now while it runs in the background */
+    uint64_t rxDone;
+    /* The bus clock in Hz, 0 for no transfer time */
+    uint32_t clock;
+    /* True iff begin has been called without end */
+    bool enabled;
+    /* The transaction timeout in us, 0 for none */
+    uint32_t timeout;
+    /* True iff a transaction has timed out since the flag was cleared */
+    bool timedOut;
+    /* The number of SCL pulses until a held SDA is released */
+    uint8_t held;
+    /* Traffic counters */
+    uint32_t transactions;
+    uint32_t bytes;
+
+    /*  Find an attached device
+
+        @param address - the 7-bit address
+        @returns the device, or NULL if none is present at that address
+    */
+    HostI2CDevice *find(uint8_t address);
+
+    /*  Let time pass for a transfer
+
+        @param length - the number of bytes after the address
+    */
+    void transfer(uint8_t length);
+
+    /*  Check for a hung bus, timing out if enabled
+
+        @returns true, iff the transaction cannot proceed
+    */
+    bool hung();
+
+public:
+    TwoWire();
+
+    void begin();
+    void end();
+    void setClock(uint32_t clock);
+    void beginTransmission(uint8_t address);
+    size_t write(uint8_t data);
+    size_t write(const uint8_t *data, size_t length);
+    uint8_t endTransmission(bool sendStop = true);
+    uint8_t requestFrom(uint8_t address, uint8_t quantity, uint8_t sendStop = 1);
+    int available();
+    int read();
+    int peek();
+    void setWireTimeout(uint32_t timeout = 25000, bool reset = false);
+    bool getWireTimeoutFlag();
+    void clearWireTimeoutFlag();
+
+    /*  Start a read that runs in the background, as i2c_t3 does (ie. for SDP3X_ASYNC_I2C)
+
+        The device answers at once, but nothing can be read until the time the transfer would
+        take at the configured clock has passed.
+        @param address - the 7-bit address
+        @param length  - the number of bytes to read
+    */
+    void sendRequest(uint8_t address, size_t length);
+
+    /*  Check if a read started by "sendRequest" has finished
+
+        Every call advances the simulated clock by 1us, as for micros.
+        @returns 1, iff the bus is idle again
+    */
+    uint8_t done();
+
+    /*  Attach a simulated device, which must outlive the bus
+
+        @param device - the device to attach
+        @returns true, iff there was room for the device
+    */
+    bool attach(HostI2CDevice *device);
+
+    /*  Detach every device
+     */
+    void detachAll();
+
+    /*  Check if the bus hardware is enabled
+
+        @returns true, iff begin has been called without end
+    */
+    bool isEnabled();
+
+    /*  Hold SDA low, as a device does when reset in the middle of a read
+
+        While held, every transaction fails. SDA is released after "pulses" SCL pulses on the SCL
+        pin, made while the bus hardware is disabled.
+        @param pulses - the number of SCL pulses needed, 0 to release at once
+    */
+    void holdSDA(uint8_t pulses);
+
+    /*  Check if SDA is held low by a device
+
+        @returns true, iff SDA is held
+    */
+    bool isSDAHeld();
+
+    /*  Count an SCL pulse made with the SCL pin
+     */
+    void pulseSCL();
+
+    /*  Get the traffic since the last "resetCounters"
+
+        @returns the number of transactions (including NACKed ones) or bytes after addresses
+    */
+    uint32_t getTransactions();
+    uint32_t getBytes();
+
+    /*  Clear the traffic counters
+     */
+    void resetCounters();
+};
+
+extern TwoWire Wire;
+extern TwoWire Wire1;
+
+#endif
@@ -0,0 +1,404 @@
+/*
+    BudgetTest.cpp - Checks the per-sample cost and footprint of the SDP3x library.
+
+    Copyright (c) 2018 Bryan T. Meyers
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+    and associated documentation files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+    BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "Check.h"
+#include "SDP3xAccumulator.h"
+#include "SDP3xAlarm.h"
+#include "SDP3xConvert.h"
+#include "SDP3xFilter.h"
+#include "SDP3xFlow.h"
+#include "SDP3xSim.h"
+#include "SDP3xT.h"
+
+/*  The instruction budgets are for GCC on x86-64 with optimisation, as in the default Release host
+    build. Other compilers, targets and debug builds generate different code, so they skip them.
+*/
+#if defined(__linux__) && defined(__x86_64__) && defined(__OPTIMIZE__) && !defined(__clang__)
+#define SDP3X_COUNT_INSTRUCTIONS
+#endif
+
+#if defined(SDP3X_COUNT_INSTRUCTIONS)
+#include <linux/perf_event.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace SDP3X;
+
+/* The number of calls counted for each check */
+const uint32_t Iterations = 10000;
+
+/* The number of times each check is counted, keeping the least to reject interrupts */
+const uint8_t Repeats = 5;
+
+/* The exit status when every check that could run passed, but the costs could not be counted */
+const int SkipStatus = 77;
+
+/* Volatile input and output, so that no call can be folded away or hoisted out of the loop */
+volatile int16_t input = 1234;
+volatile int32_t output;
+
+/*  A zero-latency bus that answers every read with the same valid 3 word reading
+
+    The frame is volatile, so that decoding it cannot be folded away or hoisted out of the loop.
+*/
+struct ReplayBus {
+    volatile uint8_t frame[9];
+    uint8_t position;
+
+    void beginTransmission(uint8_t) {
+    }
+
+    size_t write(const uint8_t *, size_t len) {
+        return len;
+    }
+
+    uint8_t endTransmission() {
+        return 0;
+    }
+
+    uint8_t requestFrom(uint8_t, uint8_t quantity) {
+        this->position = 0;
+        return (quantity > sizeof(this->frame)) ? sizeof(this->frame) : quantity;
+    }
+
+    int read() {
+        return this->frame[this->position++];
+    }
+
+    /*  Set the reading to answer with
+
+        @param words - the pressure, temperature and scale words
+    */
+    void load(const uint16_t words[3]) {
+        uint8_t i;
+        for (i = 0; i < 3; i++) {
+            this->frame[i * 3]     = (uint8_t)(words[i] >> 8);
+            this->frame[i * 3 + 1] = (uint8_t)words[i];
+            this->frame[i * 3 + 2] = crc8(crc8(0xFF, this->frame[i * 3]), this->frame[i * 3 + 1]);
+        }
+    }
+};
+
+ReplayBus replay;
+
+SDP3xSim sim(Address1, SDP31, 1);
+SDP3x sensor(Address1, DiffPressure);
+SDP3xT<SDP31, DiffPressure, Address1> fixed;
+SDP3xT<SDP31, DiffPressure, Address1, ReplayBus, replay> decoder;
+SDP3xIIR<4> iir;
+SDP3xBoxcar<8> boxcar;
+SDP3xMedian<5> median;
+SDP3xAccumulator accumulator(60, 0);
+SDP3xAlarm alarms(60);
+SDP3xFlow flow(1.0f, 60);
+
+/*  Counts the instructions retired by this process in user mode
+
+    Unlike time, the count does not depend on the speed or load of the machine, so the budgets
+    can be tight. Only Linux has the counter, and it may be disabled (ie. in a container).
+*/
+class InstructionCounter {
+private:
+    /* The perf event, -1 if unavailable */
+    int fd;
+
+public:
+    InstructionCounter() {
+        this->fd = -1;
+#if defined(SDP3X_COUNT_INSTRUCTIONS)
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.type           = PERF_TYPE_HARDWARE;
+        attr.size           = sizeof(attr);
+        attr.config         = PERF_COUNT_HW_INSTRUCTIONS;
+        attr.disabled       = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+        this->fd            = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+    }
+
+    ~InstructionCounter() {
+#if defined(SDP3X_COUNT_INSTRUCTIONS)
+        if (this->fd >= 0) {
+            close(this->fd);
+        }
+#endif
+    }
+
+    /*  Check if instructions can be counted
+
+        @returns true, iff the counter was opened
+    */
+    bool isAvailable() {
+        return this->fd >= 0;
+    }
+
+    /*  Start counting from 0
+     */
+    void start() {
+#if defined(SDP3X_COUNT_INSTRUCTIONS)
+        ioctl(this->fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(this->fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+
+    /*  Stop counting
+
+        @returns the instructions since "start"
+    */
+    uint64_t stop() {
+        uint64_t count = 0;
+#if defined(SDP3X_COUNT_INSTRUCTIONS)
+        ioctl(this->fd, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(this->fd, &count, sizeof(count)) != (ssize_t)sizeof(count)) {
+            count = 0;
+        }
+#endif
+        return count;
+    }
+};
+
+InstructionCounter counter;
+
+/*  Count the instructions of a computation
+
+    @param body - the computation, run "Iterations" times per repeat
+    @returns the least count over every repeat
+*/
+template <class Body> static uint64_t measure(Body body) {
+    uint64_t best = 0;
+    uint64_t count;
+    uint8_t r;
+    uint32_t i;
+    for (r = 0; r < Repeats; r++) {
+        counter.start();
+        for (i = 0; i < Iterations; i++) {
+            body();
+        }
+        count = counter.stop();
+        if ((r == 0) || (count < best)) {
+            best = count;
+        }
+    }
+    return best;
+}
+
+/* The instructions of the loop around each call, measured once by "testCost" */
+static uint64_t overhead = 0;
+
+/*  Check the instructions per call of a computation, net of the loop around it
+
+    @param name   - what is being checked
+    @param body   - the computation
+    @param budget - the most instructions one call may take
+*/
+template <class Body> static void cost(const char *name, Body body, uint32_t budget) {
+    uint64_t count    = measure(body);
+    uint32_t measured = (uint32_t)(((count > overhead) ? count - overhead : 0) / Iterations);
+    printf("instructions,%s,%u,%u\n", name, (unsigned)measured, (unsigned)budget);
+    checkResult(measured <= budget, name, __FILE__, __LINE__);
+}
+
+/*  Check the bus traffic of one read
+
+    @param words - the number of words the read should transfer
+    @param body  - the read
+*/
+template <class Body> static void traffic(uint8_t words, Body body) {
+    Wire.resetCounters();
+    CHECK(body());
+    // A single read of 3 bytes per word, with no command or retry in front
+    CHECK(Wire.getTransactions() == 1);
+    CHECK(Wire.getBytes() == 3UL * words);
+}
+
+static void testTraffic() {
+    int16_t p = 0;
+    int16_t t = 0;
+    int16_t s = 0;
+    traffic(1, [&]() { return sensor.readMeasurement(&p, NULL, NULL); });
+    traffic(2, [&]() { return sensor.readMeasurement(&p, &t, NULL); });
+    traffic(3, [&]() { return sensor.readMeasurement(&p, &t, &s); });
+    traffic(1, [&]() { return fixed.readMeasurement(&p, NULL, NULL); });
+    traffic(3, [&]() { return fixed.readMeasurement(&p, &t, &s); });
+}
+
+static void testCost() {
+    overhead = measure([]() { output = input; });
+    cost("readMeasurement_1", []() {
+        int16_t p = 0;
+        sensor.readMeasurement(&p, NULL, NULL);
+        output = p;
+    }, 420);
+    cost("readMeasurement_3", []() {
+        int16_t p = 0;
+        int16_t t = 0;
+        int16_t s = 0;
+        sensor.readMeasurement(&p, &t, &s);
+        output = p + t + s;
+    }, 640);
+    cost("SDP3xT_decode_1", []() {
+        int16_t p = 0;
+        decoder.readMeasurement(&p, NULL, NULL);
+        output = p;
+    }, 21);
+    cost("SDP3xT_decode_3", []() {
+        int16_t p = 0;
+        int16_t t = 0;
+        int16_t s = 0;
+        decoder.readMeasurement(&p, &t, &s);
+        output = p + t + s;
+    }, 68);
+    cost("crc8_word", []() {
+        output = crc8(crc8(0xFF, (uint8_t)(input >> 8)), (uint8_t)input);
+    }, 12);
+    cost("toMilliPascalSDP31", []() { output = toMilliPascalSDP31(input); }, 6);
+    cost("toMilliPascal", []() { output = toMilliPascal(input, 60); }, 6);
+    cost("SDP3xIIR<4>", []() { output = iir.update(input); }, 11);
+    cost("SDP3xBoxcar<8>", []() { output = boxcar.update(input); }, 27);
+    cost("SDP3xMedian<5>", []() { output = median.update(input); }, 54);
+    cost("SDP3xAccumulator", []() { output = accumulator.update(input); }, 44);
+    cost("SDP3xAlarm", []() { output = alarms.update(input); }, 66);
+    cost("SDP3xFlow", []() { output = flow.getFlow(input); }, 190);
+}
+
+/*  Bytes of a member on AVR, where pointers and enums are 2 bytes and nothing is padded
+
+    Every other member must be a fixed width type, which has the same size on the host.
+*/
+template <class T> struct AVRSize {
+    static const unsigned value = sizeof(T);
+};
+template <class T> struct AVRSize<T *> {
+    static const unsigned value = 2;
+};
+template <> struct AVRSize<Model> {
+    static const unsigned value = 2;
+};
+template <> struct AVRSize<TempCompensation> {
+    static const unsigned value = 2;
+};
+
+/*  Member layouts, in declaration order, as F(type, name, count)
+
+    Each is mirrored in a host struct that must have the size of the real class, so a member
+    added to the class but not here fails the test rather than going uncounted on AVR.
+*/
+#define SUMMARY_LAYOUT(F)                                                                         \
+    F(float, min, 1) F(float, max, 1) F(float, mean, 1) F(float, stddev, 1) F(float, rms, 1)       \
+    F(uint16_t, count, 1)
+#define SDP3X_LAYOUT(F)                                                                           \
+    F(Model, number, 1) F(TwoWire *, wire, 1) F(uint8_t, addr, 1) F(TempCompensation, comp, 1)    \
+    F(bool, pressureCRC, 1) F(bool, identified, 1) F(bool, serialCached, 1)                       \
+    F(uint64_t, serialNumber, 1) F(uint8_t, pending, 1) F(int16_t *, pendingOut, 3)               \
+    F(ReadCallback, callback, 1) F(uint16_t, sequence, 1) F(bool, missed, 1)
+#define ACCUMULATOR_LAYOUT(F)                                                                     \
+    F(uint8_t, scale, 1) F(uint16_t, window, 1) F(uint16_t, count, 1) F(int16_t, low, 1)          \
+    F(int16_t, high, 1) F(int32_t, sum, 1) F(uint64_t, sumSquares, 1)                             \
+    F(SDP3xSummary, summary, 1)
+#define ALARM_LAYOUT(F)                                                                           \
+    F(uint8_t, scale, 1) F(uint8_t, enabled, 1) F(uint8_t, active, 1) F(int16_t, aboveRaise, 1)   \
+    F(int16_t, aboveClear, 1) F(int16_t, belowRaise, 1) F(int16_t, belowClear, 1)                 \
+    F(int32_t, rate, 1) F(int16_t, last, 1) F(bool, primed, 1) F(AlarmCallback, callback, 1)
+#define FLOW_LAYOUT(F) F(uint16_t, coefficient, 1) F(uint8_t, shift, 1)
+
+#define MIRROR_MEMBER(type, name, count) type name[count];
+#define AVR_BYTES(type, name, count) +AVRSize<type>::value * (count)
+
+struct SummaryMirror {
+    SUMMARY_LAYOUT(MIRROR_MEMBER)
+};
+template <> struct AVRSize<SDP3xSummary> {
+    static const unsigned value = 0 SUMMARY_LAYOUT(AVR_BYTES);
+};
+struct SDP3xMirror {
+    SDP3X_LAYOUT(MIRROR_MEMBER)
+};
+struct AccumulatorMirror {
+    ACCUMULATOR_LAYOUT(MIRROR_MEMBER)
+};
+struct AlarmMirror {
+    ALARM_LAYOUT(MIRROR_MEMBER)
+};
+struct FlowMirror {
+    FLOW_LAYOUT(MIRROR_MEMBER)
+};
+
+/*  Check the AVR size of an object
+
+    @param name     - what is being checked
+    @param layout   - true iff the layout above matches the class on the host
+    @param measured - its size in bytes on AVR
+    @param budget   - the largest acceptable size
+*/
+static void bytes(const char *name, bool layout, unsigned measured, unsigned budget) {
+    printf("avr_bytes,%s,%u,%u\n", name, measured, budget);
+    checkResult(layout, "layout matches the class", __FILE__, __LINE__);
+    checkResult(measured <= budget, name, __FILE__, __LINE__);
+}
+
+static void testBytes() {
+    // The budgets are the current sizes, so any growth has to raise them in the same change
+#if !defined(SDP3X_STATS) && !defined(SDP3X_ASYNC_I2C)
+    bytes("SDP3x", sizeof(SDP3x) == sizeof(SDP3xMirror), 0 SDP3X_LAYOUT(AVR_BYTES), 30);
+#endif
+    // Everything is fixed at compile time, so there is no state at all
+    bytes("SDP3xT", sizeof(fixed) == 1, 1, 1);
+    bytes("SDP3xSummary", sizeof(SDP3xSummary) == sizeof(SummaryMirror),
+          AVRSize<SDP3xSummary>::value, 22);
+    bytes("SDP3xAccumulator", sizeof(SDP3xAccumulator) == sizeof(AccumulatorMirror),
+          0 ACCUMULATOR_LAYOUT(AVR_BYTES), 43);
+    bytes("SDP3xAlarm", sizeof(SDP3xAlarm) == sizeof(AlarmMirror), 0 ALARM_LAYOUT(AVR_BYTES), 20);
+    bytes("SDP3xFlow", sizeof(SDP3xFlow) == sizeof(FlowMirror), 0 FLOW_LAYOUT(AVR_BYTES), 3);
+}
+
+int main() {
+    const uint16_t words[3] = { 1234, 5000, SDP31_DiffScale };
+    Wire.attach(&sim);
+    // A zero-latency bus, so that only the CPU cost of a read is counted
+    Wire.setClock(0);
+    Wire.begin();
+    sim.setPressure(1234);
+    sim.setTemperature(5000);
+    replay.load(words);
+    CHECK(sensor.begin());
+    CHECK(sensor.startContinuous(false));
+    delay(ContStartTime);
+    alarms.setAbove(400.0f, 20.0f);
+    alarms.setBelow(-400.0f, 20.0f);
+    alarms.setRate(5.0f);
+
+    printf("check,name,measured,budget\n");
+    testTraffic();
+    testBytes();
+    if (counter.isAvailable()) {
+        testCost();
+    }
+    if ((checkReport() == 0) && !counter.isAvailable()) {
+        printf("# no instruction counter, so the cost checks were skipped\n");
+        return SkipStatus;
+    }
+    return (checkFailures == 0) ? 0 : 1;
+}
@@ -0,0 +1,60 @@
+/*
+    Check.h - Minimal assertions for the SDP3x host tests.
+
+    Copyright (c) 2018 Bryan T. Meyers
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+    and associated documentation files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+    BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SDP3X_CHECK_H
+#define SDP3X_CHECK_H
+
+#include <stdio.h>
+
+/* The number of failed checks so far */
+static int checkFailures = 0;
+
+/*  Record the outcome of a check, printing it if it failed
+
+    @param passed     - the outcome
+    @param expression - the text of the check
+    @param file       - the file of the check
+    @param line       - the line of the check
+*/
+static inline void checkResult(bool passed, const char *expression, const char *file, int line) {
+    if (!passed) {
+        printf("%s:%d: check failed: %s\n", file, line, expression);
+        checkFailures++;
+    }
+}
+
+/* Check that an expression is true, and carry on either way */
+#define CHECK(expression) checkResult((expression), #expression, __FILE__, __LINE__)
+
+/*  Report every check, for the exit status of main
+
+    @returns 0 iff every check passed
+*/
+static inline int checkReport() {
+    if (checkFailures != 0) {
+        printf("%d check(s) failed\n", checkFailures);
+        return 1;
+    }
+    printf("all checks passed\n");
+    return 0;
+}
+
+#endif
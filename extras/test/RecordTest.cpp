@@ -0,0 +1,117 @@
+/*
+    RecordTest.cpp - Checks that records round-trip and readers resynchronise.
+
+    Copyright (c) 2018 Bryan T. Meyers
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+    and associated documentation files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+    BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "Check.h"
+#include "SDP3xRecord.h"
+
+using namespace SDP3X;
+
+static void testRoundTrip() {
+    SDP3xRecordWriter writer;
+    SDP3xRecordReader reader;
+    uint8_t buffer[RecordMaxSize];
+    uint8_t addr;
+    unsigned long time;
+    int16_t pressure;
+    int16_t temp;
+    int16_t in = 1000;
+    uint8_t length;
+    uint8_t i;
+    for (i = 0; i < 10; i++) {
+        length = writer.write(buffer, Address2, 1000UL * i, in + i, &in, NULL);
+        CHECK(length <= RecordMaxSize);
+        // Every prefix is incomplete, never corrupt
+        CHECK(reader.read(buffer, length - 1, &addr, &time, &pressure, &temp, NULL, NULL) == 0);
+        CHECK(reader.read(buffer, length, &addr, &time, &pressure, &temp, NULL, NULL) == length);
+        CHECK(reader.isSynced());
+        CHECK(addr == Address2);
+        CHECK(time == 1000UL * i);
+        CHECK(pressure == in + i);
+        CHECK(temp == in);
+    }
+}
+
+static void testKeyframes() {
+    SDP3xRecordWriter writer(4);
+    uint8_t buffer[RecordMaxSize];
+    uint8_t i;
+    for (i = 0; i < 9; i++) {
+        writer.write(buffer, Address1, i, i, NULL, NULL);
+        CHECK(((buffer[1] & RecordKeyframe) != 0) == ((i % 4) == 0));
+    }
+}
+
+static void testResync() {
+    SDP3xRecordWriter writer(4);
+    SDP3xRecordReader reader;
+    uint8_t buffer[RecordMaxSize];
+    uint8_t addr;
+    unsigned long time;
+    int16_t pressure = 0;
+    uint8_t length;
+    uint8_t i;
+    for (i = 0; i < 9; i++) {
+        length = writer.write(buffer, Address1, 100UL * i, 10 * i, NULL, NULL);
+        if (i == 1) {
+            // A corrupt record loses sync, but still reports its length
+            buffer[2] ^= 0x01;
+            CHECK(reader.read(buffer, length, &addr, &time, &pressure, NULL, NULL, NULL) == length);
+            CHECK(!reader.isSynced());
+            continue;
+        }
+        CHECK(reader.read(buffer, length, &addr, &time, &pressure, NULL, NULL, NULL) == length);
+        // Records up to the next keyframe are skipped, the rest are decoded again
+        CHECK(reader.isSynced() == ((i == 0) || (i >= 4)));
+        if (reader.isSynced()) {
+            CHECK(pressure == 10 * i);
+            CHECK(time == 100UL * i);
+        }
+    }
+}
+
+static void testGarbage() {
+    SDP3xRecordReader reader;
+    uint8_t buffer[RecordMaxSize];
+    uint8_t addr;
+    unsigned long time;
+    int16_t pressure;
+    uint8_t i;
+    // Unknown flags can not be framed, so the reader moves on by one byte
+    buffer[0] = Address1;
+    buffer[1] = 0x80;
+    CHECK(reader.read(buffer, 4, &addr, &time, &pressure, NULL, NULL, NULL) == 1);
+    // Nor can a varint that never ends, once a whole record's worth has arrived
+    buffer[1] = RecordKeyframe;
+    for (i = 2; i < RecordMaxSize; i++) {
+        buffer[i] = 0xFF;
+    }
+    CHECK(reader.read(buffer, RecordMaxSize - 1, &addr, &time, &pressure, NULL, NULL, NULL) == 0);
+    CHECK(reader.read(buffer, RecordMaxSize, &addr, &time, &pressure, NULL, NULL, NULL) == 1);
+    CHECK(!reader.isSynced());
+}
+
+int main() {
+    testRoundTrip();
+    testKeyframes();
+    testResync();
+    testGarbage();
+    return checkReport();
+}
@@ -0,0 +1,662 @@
+/*
+    SimTest.cpp - Checks the simulated SDP3x device through the library.
+
+    Copyright (c) 2018 Bryan T. Meyers
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+    and associated documentation files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all copies or
+    substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+    BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+    DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "Check.h"
+#include "SDP3xAccumulator.h"
+#include "SDP3xAdaptive.h"
+#include "SDP3xAlarm.h"
+#include "SDP3xBus.h"
+#include "SDP3xCalibration.h"
+#include "SDP3xDutyCycle.h"
+#include "SDP3xEEPROM.h"
+#include "SDP3xMeasurement.h"
+#include "SDP3xRecovery.h"
+#include "SDP3xSampleRing.h"
+#include "SDP3xSim.h"
+#include "SDP3xT.h"
+
+using namespace SDP3X;
+
+/*  Put a fresh bus in place with one simulated sensor
+
+    @param sim - the sensor to attach
+*/
+static void setUp(SDP3xSim &sim) {
+    Wire.detachAll();
+    Wire.attach(&sim);
+    Wire.setClock(400000);
+    Wire.begin();
+    Wire.resetCounters();
+}
+
+static void testIdentify() {
+    SDP3xSim sim31(Address1, SDP31, 0x0123456789ABCDEFULL);
+    SDP3xSim sim32(Address2, SDP32, 42);
+    SDP3x sensor31(Address1, DiffPressure);
+    SDP3x sensor32(Address2, DiffPressure);
+    SDP3x missing(Address3, DiffPressure);
+    uint32_t pid    = 0;
+    uint64_t serial = 0;
+    setUp(sim31);
+    Wire.attach(&sim32);
+    CHECK(sensor31.begin());
+    CHECK(sensor31.getModel() == SDP31);
+    CHECK(sensor31.getPressureScale() == SDP31_DiffScale);
+    CHECK(sensor32.begin());
+    CHECK(sensor32.getModel() == SDP32);
+    CHECK(!missing.begin());
+    CHECK(sensor31.readProductID(&pid, &serial));
+    CHECK(pid == SDP31_PID);
+    CHECK(serial == 0x0123456789ABCDEFULL);
+    // Both are cached now, so no more traffic
+    Wire.resetCounters();
+    CHECK(sensor31.readProductID(&pid, &serial));
+    CHECK(Wire.getTransactions() == 0);
+}
+
+static void testContinuous() {
+    SDP3xSim sim(Address1, SDP31, 1);
+    SDP3x sensor(Address1, DiffPressure);
+    int16_t pressure = 0;
+    int16_t temp     = 0;
+    int16_t scale    = 0;
+    setUp(sim);
+    sim.setPressure(-1234);
+    sim.setTemperature(4600);
+    CHECK(sensor.begin());
+    CHECK(sensor.startContinuous(true));
+    CHECK(sim.getState() == SimContinuous);
+    CHECK(sim.isAveraging());
+    // Nothing until ContStartTime has passed
+    CHECK(!sensor.readMeasurement(&pressure, NULL, NULL));
+    delay(ContStartTime);
+    Wire.resetCounters();
+    CHECK(sensor.readMeasurement(&pressure, &temp, &scale));
+    CHECK(pressure == -1234);
+    CHECK(temp == 4600);
+    CHECK(scale == SDP31_DiffScale);
+    CHECK(Wire.getTransactions() == 1);
+    CHECK(Wire.getBytes() == 9);
+    Wire.resetCounters();
+    CHECK(sensor.readMeasurement(&pressure, NULL, NULL));
+    CHECK(Wire.getBytes() == 3);
+    // Continuous mode rejects everything but the stop command
+    CHECK(!sensor.triggerMeasurement(false));
+    CHECK(sim.getRejected() == 1);
+    CHECK(sensor.stopContinuous());
+    CHECK(sim.getState() == SimIdle);
+    CHECK(!sensor.triggerMeasurement(false));
+    delay(ContStopTime);
+    CHECK(sensor.triggerMeasurement(false));
+}
+
+static void testTriggered() {
+    SDP3xSim sim(Address1, SDP32, 1);
+    SDP3x sensor(Address1, MassFlow);
+    int16_t pressure = 0;
+    uint64_t start;
+    setUp(sim);
+    sim.setPressure(321);
+    CHECK(sensor.begin());
+    CHECK(sensor.triggerMeasurement(false));
+    // Without clock stretching, the read is not acknowledged until the reading is ready
+    CHECK(!sensor.readMeasurement(&pressure, NULL, NULL));
+    delay(TrigSettleTime);
+    CHECK(sensor.readMeasurement(&pressure, NULL, NULL));
+    CHECK(pressure == 321);
+    // A one-shot reading is only available once
+    CHECK(!sensor.readMeasurement(&pressure, NULL, NULL));
+    // With clock stretching, the read waits for the reading
+    CHECK(sensor.triggerMeasurement(true));
+    start = hostTime();
+    CHECK(sensor.readMeasurement(&pressure, NULL, NULL));
+    CHECK(hostTime() - start >= TrigSettleTime * 1000UL);
+}
+
+static void testCRCErrors() {
+    SDP3xSim sim(Address1, SDP31, 1);
+    SDP3x sensor(Address1, DiffPressure);
+    int16_t pressure = 0;
+    int16_t temp     = 0;
+    setUp(sim);
+    sim.setPressure(100);
+    CHECK(sensor.begin());
+    CHECK(sensor.startContinuous(false));
+    delay(ContStartTime);
+    sim.injectCRCError(0, 1);
+    CHECK(!sensor.readMeasurement(&pressure, NULL, NULL));
+    CHECK(sensor.readMeasurement(&pressure, NULL, NULL));
+    // A bad temperature word must not leave a good pressure word half-stored
+    pressure = 777;
+    temp     = 777;
+    sim.setPressure(200);
+    sim.injectCRCError(1, 1);
+    CHECK(!sensor.readMeasurement(&pressure, &temp, NULL));
+    CHECK(pressure == 777);
+    CHECK(temp == 777);
+    // The pressure CRC can be skipped, but the others are always checked
+    sensor.setPressureCRC(false);
+    sim.injectCRCError(0, 1);
+    CHECK(sensor.readMeasurement(&pressure, NULL, NULL));
+    sim.injectCRCError(1, 1);
+    CHECK(!sensor.readMeasurement(&pressure, &temp, NULL));
+}
+
+static void testTemplate() {
+    SDP3xSim sim(Address3, SDP32, 1);
+    SDP3xT<SDP32, DiffPressure, Address3> sensor;
+    int16_t pressure = 0;
+    setUp(sim);
+    sim.setPressure(-7);
+    CHECK(sensor.begin());
+    CHECK(sensor.startContinuous(false));
+    delay(ContStartTime);
+    CHECK(sensor.readMeasurement(&pressure, NULL, NULL));
+    CHECK(pressure == -7);
+}
+
+/*  A bus that does not derive from TwoWire, forwarding to Wire and counting transactions */
+struct ForwardBus {
+    uint8_t transactions;
+
+    void beginTransmission(uint8_t address) {
+        this->transactions++;
+        Wire.beginTransmission(address);
+    }
+
+    size_t write(const uint8_t *data, size_t len) {
+        return Wire.write(data, len);
+    }
+
+    uint8_t endTransmission() {
+        return Wire.endTransmission();
+    }
+
+    uint8_t requestFrom(uint8_t address, uint8_t quantity) {
+        this->transactions++;
+        return Wire.requestFrom(address, quantity);
+    }
+
+    int read() {
+        return Wire.read();
+    }
+};
+
+ForwardBus forwardBus;
+
+static void testTemplateBus() {
+    SDP3xSim sim(Address2, SDP31, 1);
+    SDP3xT<SDP31, MassFlow, Address2, ForwardBus, forwardBus> sensor;
+    int16_t pressure = 0;
+    int16_t temp     = 0;
+    setUp(sim);
+    sim.setPressure(123);
+    forwardBus.transactions = 0;
+    CHECK(sensor.begin());
+    CHECK(sensor.startContinuous(false));
+    delay(ContStartTime);
+    CHECK(sensor.readMeasurement(&pressure, &temp, NULL));
+    CHECK(pressure == 123);
+    // Two commands and a read to identify, one to start and one read
+    CHECK(forwardBus.transactions == 5);
+}
+
+static void testReset() {
+    SDP3xSim sim(Address1, SDP31, 1);
+    SDP3x sensor(Address1, DiffPressure);
+    setUp(sim);
+    CHECK(sensor.startContinuous(false));
+    CHECK(sensor.reset());
+    CHECK(sim.getState() == SimIdle);
+}
+
+static void testBus() {
+    SDP3xSim sim(Address1, SDP31, 1);
+    SDP3x sensor(Address1, DiffPressure);
+    SDP3xBus bus;
+    int16_t pressure = 0;
+    setUp(sim);
+    sim.setPressure(55);
+    CHECK(bus.add(&sensor));
+    // Nothing was triggered, so nothing can be ready
+    CHECK(!bus.isReady());
+    CHECK(bus.triggerAll());
+    // Every call to micros() moves the simulated clock on by 1us, ergo the small margin
+    hostAdvance(TrigSettleTime * 1000UL - 10);
+    CHECK(!bus.isReady());
+    hostAdvance(10);
+    CHECK(bus.isReady());
+    CHECK(bus.readAll(&pressure, NULL, NULL));
+    CHECK(pressure == 55);
+    CHECK(!bus.isReady());
+}
+
+static void testRing() {
+    SDP3xSim sim(Address1, SDP31, 1);
+    SDP3x sensor(Address1, DiffPressure);
+    SDP3xSampleRing<4> ring;
+    SDP3xAlarm alarm(SDP31_DiffScale);
+    int16_t pressure = 0;
+    int16_t temp     = 0;
+    setUp(sim);
+    CHECK(sensor.startContinuous(false));
+    delay(ContStartTime);
+    alarm.setAbove(5.0f, 1.0f);
+    // 10Pa on an SDP31
+    sim.setPressure(600);
+    CHECK(ring.fill(sensor, true, alarm));
+    CHECK((alarm.getActive() & AlarmAbove) != 0);
+    CHECK(ring.pop(&pressure, &temp));
+    CHECK(pressure == 600);
+    // A failed read stores nothing and does not update the hook
+    sim.setPressure(0);
+    sim.injectCRCError(0, 1);
+    CHECK(!ring.fill(sensor, false, alarm));
+    CHECK(ring.available() == 0);
+    CHECK((alarm.getActive() & AlarmAbove) != 0);
+}
+
+static void testDutyCycle() {
+    SDP3xSim sim(Address1, SDP31, 1);
+    SDP3x sensor(Address1, DiffPressure);
+    SDP3xDutyCycle sampler(sensor, 200);
+    int16_t pressure = 0;
+    unsigned long left;
+    setUp(sim);
+    sim.setPressure(42);
+    CHECK(sampler.start());
+    delay(ContStopTime);
+    CHECK(!sampler.update(&pressure, NULL));
+    CHECK(sim.getState() == SimTriggered);
+    delay(TrigSettleTime);
+    CHECK(sampler.update(&pressure, NULL));
+    CHECK(pressure == 42);
+    // Crediting slept time brings the next trigger that much closer
+    left = sampler.sleepTime();
+    CHECK(left > 100000UL);
+    sampler.addSleptTime(100000UL);
+    CHECK(sampler.sleepTime() <= left - 100000UL);
+    sampler.addSleptTime(left);
+    CHECK(sampler.sleepTime() == 0);
+    CHECK(!sampler.update(&pressure, NULL));
+    CHECK(sim.getState() == SimTriggered);
+}
+
+static void testCalibration() {
+    SDP3xSim sim(Address1, SDP31, 1);
+    SDP3x sensor(Address1, DiffPressure);
+    SDP3xCalibration cold;
+    SDP3xCalibration hot;
+    SDP3xCalibration cal;
+    setUp(sim);
+    sim.setPressure(30);
+    sim.setTemperature(5000);
+    // A single burst at one temperature gives an offset, but no slope
+    CHECK(calibrateZero(sensor, 32, true, &cold));
+    CHECK(cold.offset == 30);
+    CHECK(cold.refTemp == 5000);
+    CHECK(cold.slope == 0);
+    CHECK(sim.getState() == SimIdle);
+    sim.setPressure(40);
+    sim.setTemperature(5000 + CalibrationMinSpread - 1);
+    CHECK(calibrateZero(sensor, 32, true, &hot));
+    CHECK(!calibrateTwoPoint(cold, hot, &cal));
+    // 10 counts over 500 counts is 5.12 with 8 fraction bits
+    sim.setTemperature(5500);
+    CHECK(calibrateZero(sensor, 32, true, &hot));
+    CHECK(calibrateTwoPoint(hot, cold, &cal));
+    CHECK(cal.slope == 5);
+    CHECK(cal.offset == 40);
+    CHECK(applyCalibration(cal, 30, 5000) == 0);
+    // The offset is removed by the conversion itself, 60 counts being 1Pa on an SDP31
+    CHECK(toMilliPascal(90, SDP31_DiffScale, cold) == 1000);
+    CHECK(toMilliPascal(40, 5500, SDP31_DiffScale, cal) == 0);
+    SDP3xMeasurement measurement(1);
+    measurement.setCalibration(&cold);
+    sim.setPressure(90);
+    sim.setTemperature(5000);
+    delay(ContStopTime);
+    CHECK(sensor.startContinuous(false));
+    delay(ContStartTime);
+    CHECK(measurement.read(sensor));
+    CHECK(measurement.getPressure() == 90);
+    CHECK(measurement.getMilliPascal() == 1000);
+    measurement.setCalibration(NULL);
+    CHECK(measurement.getMilliPascal() == 1500);
+}
+
+/*  Fail reads until the supervisor takes the sensor offline, then wait out the backoff
+
+    @param supervisor - the supervisor to drive
+*/
+static void takeOffline(SDP3xSupervisor &supervisor) {
+    int16_t pressure;
+    uint8_t i;
+    for (i = 0; i < RecoveryMaxFailures; i++) {
+        CHECK(!supervisor.read(&pressure, NULL, NULL));
+    }
+    CHECK(!supervisor.isOnline());
+    delay(RecoveryMinBackoff);
+}
+
+static void testSupervisor() {
+    SDP3xSim sim(Address1, SDP31, 1);
+    SDP3x sensor(Address1, DiffPressure);
+    SDP3xSupervisor supervisor(sensor);
+    int16_t pressure = 0;
+    setUp(sim);
+    sim.setPressure(9);
+    CHECK(sensor.begin());
+    CHECK(supervisor.startContinuous(false));
+    delay(ContStartTime);
+    CHECK(supervisor.read(&pressure, NULL, NULL));
+    // A brief disconnect leaves the sensor powered, and still in continuous mode
+    sim.setPresent(false);
+    takeOffline(supervisor);
+    sim.setPresent(true);
+    CHECK(sim.getState() == SimContinuous);
+    CHECK(!supervisor.read(&pressure, NULL, NULL));
+    CHECK(supervisor.isOnline());
+    delay(ContStartTime);
+    pressure = 0;
+    CHECK(supervisor.read(&pressure, NULL, NULL));
+    CHECK(pressure == 9);
+}
+
+static void testSupervisorBus() {
+    SDP3xSim sim(Address1, SDP31, 1);
+    SDP3x sensor(Address1, DiffPressure);
+    SDP3xSupervisor supervisor(sensor);
+    int16_t pressure = 0;
+    setUp(sim);
+    sim.setPressure(9);
+    CHECK(supervisor.setBusRecovery(Wire, SDA, SCL, 400000, 25000));
+    CHECK(sensor.begin());
+    CHECK(supervisor.startContinuous(false));
+    delay(ContStartTime);
+    // A device holding SDA makes every transaction time out
+    Wire.holdSDA(3);
+    takeOffline(supervisor);
+    CHECK(Wire.getWireTimeoutFlag());
+    CHECK(!supervisor.read(&pressure, NULL, NULL));
+    CHECK(!Wire.isSDAHeld());
+    CHECK(Wire.isEnabled());
+    CHECK(supervisor.isOnline());
+    delay(ContStartTime);
+    CHECK(supervisor.read(&pressure, NULL, NULL));
+    CHECK(pressure == 9);
+}
+
+static void testDiscover() {
+    SDP3xSim a1(Address1, SDP31, 1);
+    SDP3xSim a2(Address2, SDP31, 2);
+    SDP3xSim b1(Address1, SDP31, 3);
+    SDP3xSim b2(Address2, SDP31, 4);
+    SDP3x candidates[] = { SDP3x(Address1, DiffPressure), SDP3x(Address2, DiffPressure),
+                           SDP3x(Address3, DiffPressure), SDP3x(Address1, DiffPressure, Wire1),
+                           SDP3x(Address2, DiffPressure, Wire1) };
+    SDP3xBus bus;
+    setUp(a1);
+    Wire.attach(&a2);
+    Wire1.detachAll();
+    Wire1.attach(&b1);
+    Wire1.attach(&b2);
+    Wire1.setClock(400000);
+    Wire1.begin();
+    Wire1.resetCounters();
+    // Four sensors answer, but the group is full after three
+    CHECK(bus.discover(candidates, 5) == BusMaxSensors);
+    CHECK(bus.size() == BusMaxSensors);
+    CHECK(bus.get(2) == &candidates[3]);
+    // So the last candidate is never even probed, ie. only the probe and begin of the first
+    uint32_t before = Wire1.getTransactions();
+    SDP3x last(Address1, DiffPressure, Wire1);
+    Wire1.resetCounters();
+    CHECK(last.probe());
+    CHECK(last.begin());
+    CHECK(before == Wire1.getTransactions());
+    // Nothing more fits
+    CHECK(bus.discover(candidates, 5) == 0);
+}
+
+static void testAccumulator() {
+    SDP3xAccumulator stats(60, 0);
+    uint32_t i;
+    bool closed = false;
+    for (i = 0; i < 0xFFFF; i++) {
+        closed = stats.update(60) || closed;
+    }
+    CHECK(!closed);
+    // The window is full, so this reading closes it and starts the next one
+    CHECK(stats.update(120));
+    CHECK(stats.getSummary().count == 0xFFFF);
+    CHECK(stats.getSummary().mean == 1.0f);
+    CHECK(stats.close());
+    CHECK(stats.getSummary().count == 1);
+    CHECK(stats.getSummary().mean == 2.0f);
+}
+
+static void testAdaptive() {
+    SDP3xSim sim(Address1, SDP31, 1);
+    SDP3x sensor(Address1, DiffPressure);
+    SDP3xAdaptive adaptive(sensor);
+    int16_t pressure = 0;
+    uint8_t i;
+    setUp(sim);
+    sim.setPressure(21);
+    CHECK(sensor.begin());
+    CHECK(adaptive.start(true));
+    hostAdvance(ContStartTime * 1000UL);
+    // Reads every 2ms are faster than AdaptiveFastTime, so averaging stops
+    for (i = 0; (i < 10) && adaptive.isAveraging(); i++) {
+        adaptive.read(&pressure, NULL, NULL);
+        hostAdvance(2000);
+    }
+    CHECK(!adaptive.isAveraging());
+    CHECK(sim.getState() == SimIdle);
+    // The sensor drops off the bus before it can be restarted
+    sim.setPresent(false);
+    for (i = 0; i < 5; i++) {
+        hostAdvance(ContStopTime * 1000UL);
+        CHECK(!adaptive.read(&pressure, NULL, NULL));
+    }
+    // Once back, the restart is retried without any help
+    sim.setPresent(true);
+    sim.setPressure(22);
+    pressure = 0;
+    for (i = 0; (i < 10) && (pressure != 22); i++) {
+        hostAdvance(ContStopTime * 1000UL);
+        adaptive.read(&pressure, NULL, NULL);
+    }
+    CHECK(pressure == 22);
+    CHECK(sim.getState() == SimContinuous);
+    CHECK(!adaptive.isAveraging());
+}
+
+/* The number of deferred reads completed, and the outcome of the last */
+static uint8_t readsDone = 0;
+static bool readSuccess  = false;
+
+/*  Count a completed deferred read
+
+    @param sensor  - the sensor that finished reading
+    @param success - true iff all words were read and CRC passed
+*/
+static void onRead(SDP3x *, bool success) {
+    readsDone++;
+    readSuccess = success;
+}
+
+/*  Poll a deferred read until it completes, as a loop would
+
+    @param sensor - the sensor with the pending read
+    @returns true, iff the read completed within a few ms
+*/
+static bool pollUntilDone(SDP3x &sensor) {
+    uint8_t i;
+    for (i = 0; i < 50; i++) {
+        if (sensor.poll()) {
+            return true;
+        }
+        hostAdvance(100);
+    }
+    return false;
+}
+
+static void testDeferred() {
+    SDP3xSim sim(Address1, SDP31, 1);
+    SDP3x sensor(Address1, DiffPressure);
+    int16_t pressure = 0;
+    int16_t temp     = 0;
+    uint8_t i;
+    setUp(sim);
+    sim.setPressure(31);
+    sim.setTemperature(41);
+    CHECK(sensor.begin());
+    readsDone = 0;
+    // Not ready yet, so the sensor NACKs and the read stays pending
+    CHECK(sensor.triggerMeasurement(false));
+    CHECK(sensor.beginRead(&pressure, &temp, NULL, onRead));
+    CHECK(!sensor.beginRead(&pressure, NULL, NULL, onRead));
+    for (i = 0; i < 10; i++) {
+        CHECK(!sensor.poll());
+        hostAdvance(1000);
+    }
+    CHECK(sensor.isBusy());
+    CHECK(readsDone == 0);
+    CHECK(pressure == 0);
+    // Once settled, the read completes and runs the callback
+    hostAdvance(TrigSettleTime * 1000UL);
+    CHECK(pollUntilDone(sensor));
+    CHECK(!sensor.isBusy());
+    CHECK(readsDone == 1);
+    CHECK(readSuccess);
+    CHECK(pressure == 31);
+    CHECK(temp == 41);
+    // A bad CRC completes the read too, without storing anything
+    pressure = 777;
+    temp     = 777;
+    sim.injectCRCError(1, 1);
+    CHECK(sensor.triggerMeasurement(false));
+    hostAdvance(TrigSettleTime * 1000UL);
+    CHECK(sensor.beginRead(&pressure, &temp, NULL, onRead));
+    CHECK(pollUntilDone(sensor));
+    CHECK(readsDone == 2);
+    CHECK(!readSuccess);
+    CHECK(pressure == 777);
+    CHECK(temp == 777);
+    // An abandoned read never calls back
+    CHECK(sensor.beginRead(&pressure, NULL, NULL, onRead));
+    CHECK(!sensor.poll());
+    CHECK(sensor.cancelRead());
+    CHECK(!sensor.isBusy());
+    CHECK(!sensor.cancelRead());
+    CHECK(readsDone == 2);
+#ifdef SDP3X_ASYNC_I2C
+    // The transfer runs in the background, so no poll waits for it
+    Wire.setClock(100000);
+    CHECK(sensor.triggerMeasurement(false));
+    hostAdvance(TrigSettleTime * 1000UL);
+    CHECK(sensor.beginRead(&pressure, &temp, NULL, onRead));
+    unsigned long start = micros();
+    CHECK(!sensor.poll());
+    CHECK(!sensor.poll());
+    CHECK(micros() - start < 20);
+    CHECK(pollUntilDone(sensor));
+    CHECK(readsDone == 3);
+    CHECK(readSuccess);
+#endif
+}
+
+static void testWarmBegin() {
+    SDP3xSim sim(Address1, SDP31, 1);
+    SDP3xSim swapped(Address1, SDP32, 2);
+    SDP3xSim other(Address1, SDP32, 3);
+    SDP3x first(Address1, DiffPressure);
+    SDP3x warm(Address1, DiffPressure);
+    SDP3x verified(Address1, DiffPressure);
+    SDP3x replaced(Address1, DiffPressure);
+    SDP3x onWire1(Address1, DiffPressure, Wire1);
+    SDP3xCalibration cal  = { 12, 3, 5000 };
+    SDP3xCalibration back = { 0, 0, 0 };
+    Model model;
+    uint64_t serial;
+    setUp(sim);
+    // The first start identifies the sensor and stores its model and serial number
+    CHECK(!loadModel(Address1, 0, 0, &model, NULL));
+    CHECK(warmBegin(first, 0));
+    CHECK(loadModel(Address1, 0, 0, &model, &serial));
+    CHECK(model == SDP31);
+    CHECK(serial == 1);
+    // Without verification, a later start is free
+    Wire.resetCounters();
+    CHECK(warmBegin(warm, 0, 0, false));
+    CHECK(Wire.getTransactions() == 0);
+    CHECK(warm.getModel() == SDP31);
+    // Verification is a single product information read when nothing changed
+    CHECK(warmBegin(verified, 0));
+    CHECK(Wire.getTransactions() == 3);
+    CHECK(verified.getModel() == SDP31);
+    // A sensor swapped for the other model is identified again, and replaces the stored one
+    setUp(swapped);
+    CHECK(warmBegin(replaced, 0));
+    CHECK(replaced.getModel() == SDP32);
+    CHECK(loadModel(Address1, 0, 0, &model, &serial));
+    CHECK(model == SDP32);
+    CHECK(serial == 2);
+    // Each bus has its own slots
+    Wire1.detachAll();
+    Wire1.attach(&other);
+    Wire1.begin();
+    CHECK(!loadModel(Address1, 1, 0, &model, NULL));
+    CHECK(warmBegin(onWire1, 0, 1));
+    CHECK(loadModel(Address1, 1, 0, &model, &serial));
+    CHECK(serial == 3);
+    CHECK(storeCalibration(Address1, 1, cal, 0));
+    CHECK(!loadCalibration(Address1, 0, 0, &back));
+    CHECK(loadCalibration(Address1, 1, 0, &back));
+    CHECK((back.offset == 12) && (back.slope == 3) && (back.refTemp == 5000));
+    CHECK(loadModel(Address1, 1, 0, &model, &serial));
+    CHECK(model == SDP32);
+    CHECK(!storeModel(0x40, 0, SDP31, 1, 0));
+}
+
+int main() {
+    testIdentify();
+    testContinuous();
+    testTriggered();
+    testCRCErrors();
+    testDeferred();
+    testTemplate();
+    testTemplateBus();
+    testReset();
+    testBus();
+    testDiscover();
+    testRing();
+    testDutyCycle();
+    testAdaptive();
+    testCalibration();
+    testWarmBegin();
+    testAccumulator();
+    testSupervisor();
+    testSupervisorBus();
+    return checkReport();
+}